@@ -0,0 +1,191 @@
+//
+// Throughput of ButterworthFilter in samples/s per kernel and padtype: lfilter,
+// filtfilt (each padtype, allocating and with a reused Workspace), the FFT
+// backend, Auto backend selection, 12-channel filtfilt along either axis,
+// float32 entry points and the streaming handle, for BA and SOS designs of
+// several orders. Heap allocations per sample are counted as well.
+//
+// Writes the same JSON layout as google benchmark (name, items_per_second,
+// allocs/sample) plus noise, the relative spread of the repeats. Timings are only
+// comparable on one machine: run the benchmark for the old and the new build and
+// compare the two files with compare_baseline.py.
+//
+//     butterworth_benchmark [--samples N] [--repeat R] [--out result.json]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "butterworth_filter.h"
+#include "alloc_counter.h"
+
+struct Case {
+    std::string name;
+    std::function<void()> fn;
+    std::vector<double> times;
+    long long allocs = 0;
+};
+
+// 一次计时; 分配次数取最后一次 (第一次可能在给 Workspace 扩容)
+static void time_once(Case &c) {
+    const long long a0 = g_allocs.load(std::memory_order_relaxed);
+    const auto t0 = std::chrono::steady_clock::now();
+    c.fn();
+    c.times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    c.allocs = g_allocs.load(std::memory_order_relaxed) - a0;
+}
+
+int main(int argc, char **argv) {
+    size_t samples = (size_t) 1 << 18;
+    int repeat = 7;
+    const char *out = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--samples") && i + 1 < argc) samples = (size_t) std::atoll(argv[++i]);
+        else if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc) repeat = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--out") && i + 1 < argc) out = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: %s [--samples N] [--repeat R] [--out result.json]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::mt19937 gen(42);
+    std::normal_distribution<double> nd;
+    std::vector<double> x(samples);
+    for (double &v : x) v = nd(gen);
+    std::vector<float> x32(x.begin(), x.end());
+    std::vector<double> y(samples);
+    std::vector<double> ym;     // 多通道输出, 长度 samples / 12 * 12, 与 y 分开
+    std::vector<float> y32(samples);
+
+    // BA 只取条件数良好的低阶设计, 高阶用 SOS
+    struct Kernel {
+        std::string name;
+        ButterworthFilter filter;
+    };
+    const auto ba = [](int order) {
+        const ButterworthFilter f = ButterworthFilter::from_params(order, 2.0, "lowpass", {0.2});
+        // from_params 输出 SOS, 展开成 b/a: 逐节多项式相乘
+        std::vector<double> b{1.0}, a{1.0};
+        for (const auto &s : f.sos()) {
+            std::vector<double> nb(b.size() + 2, 0.0), na(a.size() + 2, 0.0);
+            for (size_t i = 0; i < b.size(); ++i)
+                for (int k = 0; k < 3; ++k) nb[i + k] += b[i] * s[k];
+            for (size_t i = 0; i < a.size(); ++i)
+                for (int k = 0; k < 3; ++k) na[i + k] += a[i] * s[3 + k];
+            b.swap(nb);
+            a.swap(na);
+        }
+        return ButterworthFilter::from_ba(b, a);
+    };
+    const std::vector<Kernel> kernels = {
+        {"ba2", ba(2)},
+        {"ba4", ba(4)},
+        {"sos4", ButterworthFilter::from_params(4, 2.0, "lowpass", {0.2})},
+        {"sos8", ButterworthFilter::from_params(8, 2.0, "lowpass", {0.05})},
+        {"sos12bp", ButterworthFilter::from_params(12, 2.0, "bandpass", {0.1, 0.2})},
+    };
+    const struct {
+        const char *name;
+        ButterworthFilter::PadType type;
+    } pads[] = {
+        {"odd", ButterworthFilter::PadType::Odd},
+        {"even", ButterworthFilter::PadType::Even},
+        {"constant", ButterworthFilter::PadType::Constant},
+        {"none", ButterworthFilter::PadType::None},
+    };
+
+    // Workspace / Stream 被 lambda 按引用捕获, deque 扩容时不搬动元素
+    std::deque<ButterworthFilter::Workspace> workspaces;
+    std::deque<ButterworthFilter::Stream> streams;
+    std::vector<Case> cases;
+    const auto add = [&](const std::string &name, std::function<void()> fn) {
+        cases.push_back({name, std::move(fn), {}, 0});
+    };
+    for (const Kernel &k : kernels) {
+        const ButterworthFilter &f = k.filter;
+        add("lfilter/" + k.name, [&] {
+            y = f.lfilter(x.data(), samples).first;
+        });
+        for (const auto &p : pads) {
+            add("filtfilt/" + k.name + "/" + p.name, [&] {
+                y = f.filtfilt(x.data(), samples, p.type);
+            });
+        }
+        ButterworthFilter::Workspace &ws = (workspaces.push_back(f.workspace(samples)), workspaces.back());
+        add("filtfilt_workspace/" + k.name + "/odd", [&] {
+            f.filtfilt(x.data(), samples, y.data(), ws);
+        });
+        add("filtfilt_fft/" + k.name + "/odd", [&] {
+            y = f.filtfilt(x.data(), samples, ButterworthFilter::PadType::Odd, -1,
+                           ButterworthFilter::FiltfiltBackend::FFT);
+        });
+        // Auto 不应比 filtfilt/<kernel>/odd 慢
+        add("filtfilt_auto/" + k.name + "/odd", [&] {
+            y = f.filtfilt(x.data(), samples, ButterworthFilter::PadType::Odd, -1,
+                           ButterworthFilter::FiltfiltBackend::Auto);
+        });
+        // 12 通道各 samples / 12 点, 总样本数与单通道用例相同: 理想情况下 ns/sample 是 filtfilt/<kernel>/odd 的 1/12
+        add("filtfilt_multi12_axis0/" + k.name + "/odd", [&] {
+            ym = f.filtfilt_multi(x.data(), samples / 12, 12, 0, ButterworthFilter::PadType::Odd, -1);
+        });
+        add("filtfilt_multi12_axis1/" + k.name + "/odd", [&] {
+            ym = f.filtfilt_multi(x.data(), 12, samples / 12, 1, ButterworthFilter::PadType::Odd, -1);
+        });
+        add("filtfilt_f32/" + k.name + "/odd", [&] {
+            f.filtfilt(x32.data(), samples, y32.data(), ws);
+        });
+        ButterworthFilter::Stream &st = (streams.push_back(f.stream()), streams.back());
+        add("stream/" + k.name, [&] {
+            st.reset();
+            st.process(x.data(), y.data(), samples);
+        });
+    }
+
+    // 各用例轮流计时 repeat 轮, 机器上一阵干扰只会拖慢每个用例的一次而不是某个用例的全部;
+    // 取最快的一次, noise = (中位数 - 最快) / 最快, 供比较时区分噪声与真实变慢
+    for (int r = 0; r < std::max(repeat, 1); ++r)
+        for (Case &c : cases) time_once(c);
+
+    struct Result {
+        std::string name;
+        double items_per_second;
+        double allocs_per_sample;
+        double noise;
+    };
+    std::vector<Result> results;
+    for (Case &c : cases) {
+        std::sort(c.times.begin(), c.times.end());
+        const double best = c.times.front(), median = c.times[c.times.size() / 2];
+        results.push_back({c.name, (double) samples / best, (double) c.allocs / (double) samples, (median - best) / best});
+        const Result &res = results.back();
+        std::printf("%-36s %12.3e samples/s %8.2f ns/sample %8.4f allocs/sample %6.1f%% noise\n",
+                    res.name.c_str(), res.items_per_second, 1e9 / res.items_per_second, res.allocs_per_sample,
+                    100 * res.noise);
+    }
+
+    if (out) {
+        FILE *fp = std::fopen(out, "w");
+        if (!fp) {
+            std::fprintf(stderr, "cannot write %s\n", out);
+            return 2;
+        }
+        std::fprintf(fp, "{\n  \"benchmarks\": [\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            std::fprintf(fp, "    {\"name\": \"%s\", \"items_per_second\": %.17g, \"allocs/sample\": %.17g, "
+                         "\"noise\": %.17g}%s\n",
+                         results[i].name.c_str(), results[i].items_per_second, results[i].allocs_per_sample,
+                         results[i].noise, i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(fp, "  ]\n}\n");
+        std::fclose(fp);
+    }
+    return 0;
+}
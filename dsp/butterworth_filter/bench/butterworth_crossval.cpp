@@ -0,0 +1,204 @@
+//
+// Cross-validation of ButterworthFilter against the SciPy reference fixtures
+// written by generate_fixtures.py: from_params designs, sosfilt_zi / lfilter_zi,
+// lfilter and filtfilt (every padtype) for orders 1-12, all four btypes and
+// edge-case cutoffs. Prints the worst error per check and exits with status 1
+// if any check exceeds its tolerance.
+//
+//     butterworth_crossval [bench/fixtures/scipy_reference.bin]
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "butterworth_filter.h"
+
+// NaN / Inf 误差必须算失败; -ffinite-math-only (-ffast-math) 下编译器假定不存在 NaN, 比较会被优化掉
+#if defined(__FINITE_MATH_ONLY__) && __FINITE_MATH_ONLY__
+#error "butterworth_crossval must be built without -ffast-math / -ffinite-math-only"
+#endif
+
+#ifndef BUTTERWORTH_FIXTURE
+#define BUTTERWORTH_FIXTURE "bench/fixtures/scipy_reference.bin"
+#endif
+
+using Record = std::map<std::string, std::vector<double>>;
+
+static const char *kBtypes[] = {"lowpass", "highpass", "bandpass", "bandstop"};
+
+// fixture: b'BWFX', uint32 version, then (uint16 key length, key, uint32 count, count float64) records
+static bool load_fixture(const char *path, std::vector<double> &x, std::vector<Record> &cases) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    uint32_t version = 0;
+    if (!in.read(magic, 4) || std::memcmp(magic, "BWFX", 4) != 0) return false;
+    if (!in.read(reinterpret_cast<char *>(&version), 4) || version != 1) return false;
+
+    uint16_t klen;
+    while (in.read(reinterpret_cast<char *>(&klen), 2)) {
+        std::string key(klen, '\0');
+        uint32_t count = 0;
+        in.read(&key[0], klen);
+        in.read(reinterpret_cast<char *>(&count), 4);
+        std::vector<double> v(count);
+        if (!in.read(reinterpret_cast<char *>(v.data()), (std::streamsize) (count * sizeof(double)))) return false;
+        if (key == "x") x = std::move(v);
+        else if (key == "case") cases.push_back({{key, std::move(v)}});
+        else if (!cases.empty()) cases.back()[key] = std::move(v);
+        else return false;
+    }
+    return !x.empty() && !cases.empty();
+}
+
+// 误差取最大值时 NaN 要传下去, std::max 遇到 NaN 会按比较结果把它丢掉
+static double max_err(double a, double b) {
+    return (a > b || std::isnan(a)) ? a : b;
+}
+
+static double max_abs(const std::vector<double> &v) {
+    double m = 0.0;
+    for (double e : v) m = std::max(m, std::fabs(e));
+    return m;
+}
+
+// max|y - ref| / scale, scale 默认为 max|ref|
+static double rel_err(const std::vector<double> &y, const std::vector<double> &ref, double scale = 0.0) {
+    if (y.size() != ref.size()) return INFINITY;
+    double err = 0.0;
+    for (size_t i = 0; i < ref.size(); ++i) err = max_err(err, std::fabs(y[i] - ref[i]));
+    if (scale == 0.0) scale = max_abs(ref);
+    return scale > 0.0 ? err / scale : err;
+}
+
+// 二阶节按分母就近配对后比较, 不要求顺序一致: 带宽关于 fs/4 对称时 (如 [0.01, 0.99]) 极点成对等模,
+// zpk2sos 按模排序时的并列由舍入决定, SciPy 与本实现的节顺序可能不同, 但级联是同一个滤波器.
+// 分子按该节最大系数归一化后比较形状, 总增益 (各节分子最大系数之积) 另外比较相对误差; 分母 (a0 = 1) 取绝对误差
+static double sos_err(const std::vector<ButterworthFilter::SOSSection> &sos, const std::vector<double> &ref) {
+    const size_t ns = sos.size();
+    if (ns * 6 != ref.size()) return INFINITY;
+    auto bscale = [](const double *r) { return std::max({std::fabs(r[0]), std::fabs(r[1]), std::fabs(r[2])}); };
+    auto dist = [&](const double *a, const double *r) {
+        const double sa = bscale(a), sr = bscale(r);
+        double d = 0.0;
+        for (int k = 0; k < 3; ++k) d = max_err(d, std::fabs(a[k] / sa - r[k] / sr));
+        for (int k = 3; k < 6; ++k) d = max_err(d, std::fabs(a[k] - r[k]));
+        return d;
+    };
+
+    double err = 0.0, gain = 1.0, gain_ref = 1.0;
+    std::vector<bool> used(ns, false);
+    for (size_t s = 0; s < ns; ++s) {
+        const double *r = ref.data() + 6 * s;
+        gain_ref *= bscale(r);
+        size_t best = ns;
+        double best_d = INFINITY;
+        for (size_t t = 0; t < ns; ++t) {
+            if (used[t]) continue;
+            const double d = dist(sos[t].data(), r);
+            if (best == ns || d < best_d) {
+                best_d = d;
+                best = t;
+            }
+        }
+        used[best] = true;
+        gain *= bscale(sos[best].data());
+        err = max_err(err, best_d);
+    }
+    return max_err(err, std::fabs(gain - gain_ref) / gain_ref);
+}
+
+static std::vector<ButterworthFilter::SOSSection> to_sections(const std::vector<double> &v) {
+    std::vector<ButterworthFilter::SOSSection> sos(v.size() / 6);
+    for (size_t s = 0; s < sos.size(); ++s)
+        for (int k = 0; k < 6; ++k) sos[s][k] = v[6 * s + k];
+    return sos;
+}
+
+struct Check {
+    Check(const char *name, double tol) : name(name), tol(tol) {}
+
+    const char *name;
+    double tol;
+    double worst = 0.0;
+    std::string worst_case;
+    int count = 0;
+    int failed = 0;
+
+    void add(double err, const std::string &label) {
+        ++count;
+        if (!(std::isfinite(err) && err <= tol)) ++failed;
+        // 出现过 NaN / Inf 就一直报告它
+        if (std::isfinite(worst) && !(err <= worst)) {
+            worst = err;
+            worst_case = label;
+        }
+    }
+};
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : BUTTERWORTH_FIXTURE;
+    std::vector<double> x;
+    std::vector<Record> cases;
+    if (!load_fixture(path, x, cases)) {
+        std::fprintf(stderr, "cannot read fixture %s (run bench/generate_fixtures.py)\n", path);
+        return 2;
+    }
+
+    // 滤波输出的误差相对输入 max|x|: 窄带设计的输出可能比输入小几个数量级, 相对这么小的输出,
+    // 递推本身的舍入 (SciPy 也一样, 系数扰动 1e-13 输出就变 1e-7) 会被放大; zi 相对 max|ref|
+    Check design{"from_params sos", 1e-10};
+    Check sos_zi{"sosfilt_zi", 1e-10};
+    Check lfilt{"lfilter (sos)", 1e-10};
+    Check ff[4] = {{"filtfilt odd", 1e-9}, {"filtfilt even", 1e-9},
+                   {"filtfilt constant", 1e-9}, {"filtfilt none", 1e-9}};
+    Check ba_zi{"lfilter_zi", 1e-10};
+    Check ba_lfilt{"lfilter (ba)", 1e-10};
+    Check ba_ff{"filtfilt (ba) odd", 1e-9};
+    const char *ff_keys[4] = {"filtfilt_odd", "filtfilt_even", "filtfilt_constant", "filtfilt_none"};
+    const ButterworthFilter::PadType ff_pads[4] = {ButterworthFilter::PadType::Odd, ButterworthFilter::PadType::Even,
+                                                   ButterworthFilter::PadType::Constant, ButterworthFilter::PadType::None};
+
+    const double xs = max_abs(x);
+    for (Record &c : cases) {
+        const std::vector<double> &meta = c["case"];
+        const int order = (int) meta[0];
+        const std::string btype = kBtypes[(int) meta[1]];
+        const std::vector<double> cutoff(meta.begin() + 3, meta.begin() + 3 + (int) meta[2]);
+        char label[96];
+        std::snprintf(label, sizeof(label), "order %d %s [%g%s%g]", order, btype.c_str(), cutoff[0],
+                      cutoff.size() > 1 ? ", " : "", cutoff.size() > 1 ? cutoff[1] : 0.0);
+
+        const ButterworthFilter f = ButterworthFilter::from_params(order, 2.0, btype, cutoff);
+        design.add(sos_err(f.sos(), c["sos"]), label);
+        sos_zi.add(rel_err(ButterworthFilter::sosfilt_zi(to_sections(c["sos"])), c["sosfilt_zi"]), label);
+        lfilt.add(rel_err(f.lfilter(x).first, c["lfilter"], xs), label);
+        for (int p = 0; p < 4; ++p) {
+            if (!c.count(ff_keys[p])) continue;
+            ff[p].add(rel_err(f.filtfilt(x, ff_pads[p]), c[ff_keys[p]], xs), label);
+        }
+
+        if (c.count("ba_b")) {
+            const ButterworthFilter g = ButterworthFilter::from_ba(c["ba_b"], c["ba_a"]);
+            ba_zi.add(rel_err(ButterworthFilter::lfilter_zi(c["ba_b"], c["ba_a"]), c["lfilter_zi"]), label);
+            ba_lfilt.add(rel_err(g.lfilter(x).first, c["ba_lfilter"], xs), label);
+            ba_ff.add(rel_err(g.filtfilt(x), c["ba_filtfilt_odd"], xs), label);
+        }
+    }
+
+    int failed = 0;
+    std::printf("%zu cases from %s\n", cases.size(), path);
+    std::printf("%-20s %6s %10s %10s  %s\n", "check", "cases", "tol", "worst", "worst case");
+    for (const Check *k : {&design, &sos_zi, &lfilt, &ff[0], &ff[1], &ff[2], &ff[3], &ba_zi, &ba_lfilt, &ba_ff}) {
+        std::printf("%-20s %6d %10.1e %10.2e  %s%s\n", k->name, k->count, k->tol, k->worst,
+                    k->worst_case.c_str(), k->failed ? "  FAILED" : "");
+        failed += k->failed;
+    }
+    if (failed) std::printf("%d checks out of tolerance\n", failed);
+    return failed ? 1 : 0;
+}
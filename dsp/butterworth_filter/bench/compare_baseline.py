@@ -0,0 +1,75 @@
+#!/usr/bin/env python
+# encoding: utf-8
+"""
+Compare two butterworth_benchmark / pybind_benchmark.py runs made on the same
+machine, e.g. the build before and after a change.
+
+Absolute ns/sample numbers do not carry over between machines, so there is no
+committed baseline: record one with the old build and compare the new build
+against it. A case regresses when its ns/sample grows by more than --threshold
+plus the noise of both runs (relative spread of the repeats, reported by
+butterworth_benchmark), or when it allocates per sample and the baseline did
+not. Exits with status 1 if anything regressed. Correctness is checked
+separately by butterworth_crossval against the SciPy fixtures.
+
+	butterworth_benchmark --out base.json        # old build
+	butterworth_benchmark --out result.json      # new build
+	python bench/compare_baseline.py base.json result.json [pybind_result.json]
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_results(paths):
+	results = {}
+	for path in paths:
+		with open(path) as f:
+			data = json.load(f)
+		for b in data['benchmarks']:
+			results[b['name']] = {
+				'ns_per_sample': 1e9 / b['items_per_second'],
+				'allocs_per_sample': b.get('allocs/sample', 0.0),
+				'noise': b.get('noise', 0.0),
+			}
+	return results
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+	parser.add_argument('baseline', help='results of the reference build on this machine')
+	parser.add_argument('results', nargs='+')
+	parser.add_argument('--threshold', type=float, default=0.10,
+						help='allowed relative slowdown on top of the measured noise (default 0.10)')
+	args = parser.parse_args()
+
+	current = load_results(args.results)
+	baseline = load_results([args.baseline])
+
+	regressions = 0
+	print('%-40s %12s %12s %8s %8s' % ('case', 'base ns', 'now ns', 'change', 'allowed'))
+	for name in sorted(current):
+		now = current[name]
+		base = baseline.get(name)
+		if base is None:
+			print('%-40s %12s %12.2f %8s' % (name, '-', now['ns_per_sample'], 'new'))
+			continue
+		change = now['ns_per_sample'] / base['ns_per_sample'] - 1.0
+		allowed = args.threshold + base['noise'] + now['noise']
+		allocating = now['allocs_per_sample'] > 0 and base['allocs_per_sample'] == 0
+		flag = ''
+		if change > allowed or allocating:
+			flag = ' REGRESSION' + (' (allocates)' if allocating else '')
+			regressions += 1
+		print('%-40s %12.2f %12.2f %+7.1f%% %7.1f%%%s' % (
+			name, base['ns_per_sample'], now['ns_per_sample'], 100 * change, 100 * allowed, flag))
+	for name in sorted(set(baseline) - set(current)):
+		print('%-40s missing from results' % name)
+
+	print('%d regression(s)' % regressions)
+	return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())
@@ -0,0 +1,107 @@
+#!/usr/bin/env python
+# encoding: utf-8
+"""
+Throughput of the pybind module against SciPy, in samples/s per kernel and
+padtype: lfilter / sosfilt and filtfilt / sosfiltfilt for BA and SOS designs.
+Every timed case is also checked against the SciPy output (max error relative
+to max|x|), so a faster result that drifted is reported as a mismatch.
+
+Writes the same JSON layout as butterworth_benchmark (name, items_per_second,
+noise), so compare_baseline.py can compare two runs made on the same machine.
+The py/ vs scipy/ ratio printed per case is measured in one run and needs no
+reference at all.
+
+	python bench/pybind_benchmark.py --out pybind_result.json
+"""
+
+import argparse
+import json
+import os
+import sys
+import time
+
+import numpy as np
+from scipy import signal
+
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'lib'))
+import butterworth_filter
+
+BF = butterworth_filter.ButterworthFilter
+PADS = {
+	'odd': (butterworth_filter.PadType.Odd, 'odd'),
+	'even': (butterworth_filter.PadType.Even, 'even'),
+	'constant': (butterworth_filter.PadType.Constant, 'constant'),
+	'none': (butterworth_filter.PadType.NoPad, None),
+}
+TOL = 1e-9
+
+
+def best_rate(fn, samples, repeat):
+	# 取最快的一次; noise 为中位数相对最快的偏差, 同 butterworth_benchmark
+	times = []
+	for _ in range(max(repeat, 1)):
+		t0 = time.perf_counter()
+		fn()
+		times.append(time.perf_counter() - t0)
+	times.sort()
+	best, median = times[0], times[len(times) // 2]
+	return samples / best, (median - best) / best
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+	parser.add_argument('--out', help='write results as JSON to this file')
+	parser.add_argument('--samples', type=int, default=1 << 18)
+	parser.add_argument('--repeat', type=int, default=5)
+	args = parser.parse_args()
+
+	x = np.random.default_rng(42).standard_normal(args.samples)
+	scale = np.max(np.abs(x))
+	# (名称, 本模块的滤波器, SciPy 的 lfilter, SciPy 的 filtfilt)
+	kernels = []
+	for order in (2, 4):
+		b, a = signal.butter(order, 0.2)
+		kernels.append(('ba%d' % order, BF.from_ba(b.tolist(), a.tolist()),
+						lambda v, b=b, a=a: signal.lfilter(b, a, v),
+						lambda v, pad, b=b, a=a: signal.filtfilt(b, a, v, padtype=pad)))
+	for name, order, btype, wn in (('sos4', 4, 'lowpass', [0.2]), ('sos8', 8, 'lowpass', [0.05]),
+								   ('sos12bp', 12, 'bandpass', [0.1, 0.2])):
+		sos = signal.butter(order, wn if len(wn) > 1 else wn[0], btype, output='sos')
+		kernels.append((name, BF.from_params(order, 2.0, btype, wn),
+						lambda v, sos=sos: signal.sosfilt(sos, v),
+						lambda v, pad, sos=sos: signal.sosfiltfilt(sos, v, padtype=pad)))
+
+	results = []
+	mismatches = 0
+
+	def record(bench, rate_py, rate_ref, err):
+		nonlocal mismatches
+		flag = '' if err <= TOL else '  MISMATCH'
+		mismatches += err > TOL
+		(rate_py, noise_py), (rate_ref, noise_ref) = rate_py, rate_ref
+		results.append({'name': 'py/' + bench, 'items_per_second': rate_py, 'noise': noise_py})
+		results.append({'name': 'scipy/' + bench, 'items_per_second': rate_ref, 'noise': noise_ref})
+		print('%-32s %10.2f ns/sample  scipy %10.2f ns/sample  x%5.1f  err %.1e%s'
+			  % (bench, 1e9 / rate_py, 1e9 / rate_ref, rate_py / rate_ref, err, flag))
+
+	for name, filt, ref_lfilter, ref_filtfilt in kernels:
+		err = np.max(np.abs(filt.lfilter(x)[0] - ref_lfilter(x))) / scale
+		record('lfilter/' + name,
+			   best_rate(lambda: filt.lfilter(x), args.samples, args.repeat),
+			   best_rate(lambda: ref_lfilter(x), args.samples, args.repeat), err)
+		for pad, (padtype, scipy_pad) in PADS.items():
+			err = np.max(np.abs(filt.filtfilt(x, padtype=padtype) - ref_filtfilt(x, scipy_pad))) / scale
+			record('filtfilt/%s/%s' % (name, pad),
+				   best_rate(lambda: filt.filtfilt(x, padtype=padtype), args.samples, args.repeat),
+				   best_rate(lambda: ref_filtfilt(x, scipy_pad), args.samples, args.repeat), err)
+
+	if args.out:
+		with open(args.out, 'w') as f:
+			json.dump({'benchmarks': results}, f, indent=2)
+	if mismatches:
+		print('%d case(s) disagree with scipy by more than %.0e' % (mismatches, TOL))
+	return 1 if mismatches else 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())
@@ -2,26 +2,36 @@
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <vector>
 
 #include "butterworth_filter.h"
+#include "detrend.h"
 
 namespace py = pybind11;
 
-static void require_1d_c_f64(const py::array& a) {
-    if (!a.dtype().is(py::dtype::of<double>()))
-        throw std::invalid_argument("expected np.ndarray dtype=float64");
+// T = double 或 float (float32 入口)
+template <class T = double>
+static void require_1d_c(const py::array& a) {
+    if (!a.dtype().is(py::dtype::of<T>()))
+        throw std::invalid_argument(sizeof(T) == 4 ? "expected np.ndarray dtype=float32"
+                                                   : "expected np.ndarray dtype=float64");
     if (a.ndim() != 1)
         throw std::invalid_argument("expected 1D array");
     if (!(a.flags() & py::array::c_style))
         throw std::invalid_argument("expected C-contiguous array (use np.ascontiguousarray(x, dtype=np.float64))");
 
     py::buffer_info info = a.request();
-    if (info.strides[0] != (py::ssize_t)sizeof(double))
+    if (info.strides[0] != (py::ssize_t)sizeof(T))
         throw std::invalid_argument("expected contiguous stride (use np.ascontiguousarray)");
 }
 
+static bool is_f32(const py::array& a) {
+    return a.dtype().is(py::dtype::of<float>());
+}
+
 static void require_2d_c_f64(const py::array& a, py::ssize_t cols) {
     if (!a.dtype().is(py::dtype::of<double>()))
         throw std::invalid_argument("expected np.ndarray dtype=float64");
@@ -37,10 +47,11 @@ static void require_2d_c_f64(const py::array& a, py::ssize_t cols) {
         throw std::invalid_argument("expected contiguous inner stride");
 }
 
-static std::pair<const double*, size_t> as_ptr_len_1d(const py::array& a) {
-    require_1d_c_f64(a);
+template <class T = double>
+static std::pair<const T*, size_t> as_ptr_len_1d(const py::array& a) {
+    require_1d_c<T>(a);
     py::buffer_info info = a.request();
-    return {static_cast<const double*>(info.ptr), (size_t)info.shape[0]};
+    return {static_cast<const T*>(info.ptr), (size_t)info.shape[0]};
 }
 
 static std::vector<ButterworthFilter::SOSSection> as_sos_sections(const py::object& sos_obj) {
@@ -69,7 +80,35 @@ static std::vector<ButterworthFilter::SOSSection> as_sos_sections(const py::obje
 }
 
 // Wrap vector<double> into numpy array with zero-copy output using capsule lifetime.
-static py::array vec_to_ndarray(std::vector<double>&& v) {
+template <class T>
+static py::array vec_to_ndarray(std::vector<T>&& v) {
+    auto* pv = new std::vector<T>(std::move(v));
+    py::capsule cap(pv, [](void* p) { delete reinterpret_cast<std::vector<T>*>(p); });
+
+    return py::array(
+        py::buffer_info(
+            pv->data(),
+            (py::ssize_t)sizeof(T),
+            py::format_descriptor<T>::format(),
+            1,
+            {(py::ssize_t)pv->size()},
+            {(py::ssize_t)sizeof(T)}
+        ),
+        cap
+    );
+}
+
+// 多通道输入: C 连续的 float64 二维数组
+static void require_2d_data_f64(const py::array& a) {
+    if (!a.dtype().is(py::dtype::of<double>()))
+        throw std::invalid_argument("expected np.ndarray dtype=float64");
+    if (a.ndim() != 2)
+        throw std::invalid_argument("expected 2D array");
+    if (!(a.flags() & py::array::c_style))
+        throw std::invalid_argument("expected C-contiguous array (use np.ascontiguousarray(x, dtype=np.float64))");
+}
+
+static py::array vec_to_ndarray_2d(std::vector<double>&& v, size_t rows, size_t cols) {
     auto* pv = new std::vector<double>(std::move(v));
     py::capsule cap(pv, [](void* p) { delete reinterpret_cast<std::vector<double>*>(p); });
 
@@ -78,14 +117,33 @@ static py::array vec_to_ndarray(std::vector<double>&& v) {
             pv->data(),
             (py::ssize_t)sizeof(double),
             py::format_descriptor<double>::format(),
-            1,
-            {(py::ssize_t)pv->size()},
-            {(py::ssize_t)sizeof(double)}
+            2,
+            {(py::ssize_t)rows, (py::ssize_t)cols},
+            {(py::ssize_t)(cols * sizeof(double)), (py::ssize_t)sizeof(double)}
         ),
         cap
     );
 }
 
+// freqz/sosfreqz 的结果转成 (w, magnitude, phase, group_delay) 四个 ndarray
+static py::tuple response_to_tuple(ButterworthFilter::FrequencyResponse&& r) {
+    return py::make_tuple(vec_to_ndarray(std::move(r.w)),
+                          vec_to_ndarray(std::move(r.magnitude)),
+                          vec_to_ndarray(std::move(r.phase)),
+                          vec_to_ndarray(std::move(r.group_delay)));
+}
+
+// out 为 None 时分配新数组; 否则必须是与 x 等长、可写、C 连续的 float64 一维数组 (可以就是 x 本身, 即原地滤波)
+template <class T = double>
+static T* require_out_1d(const py::array& out, size_t n) {
+    require_1d_c<T>(out);
+    if ((size_t)out.shape(0) != n)
+        throw std::invalid_argument("out must have the same length as x");
+    if (!out.writeable())
+        throw std::invalid_argument("out must be writeable");
+    return static_cast<T*>(out.request(true).ptr);
+}
+
 PYBIND11_MODULE(butterworth_filter, m) {
     m.doc() = "SciPy-matching filtfilt/lfilter with full-chain zero-copy numpy I/O";
 
@@ -97,6 +155,102 @@ PYBIND11_MODULE(butterworth_filter, m) {
         .value("Constant", ButterworthFilter::PadType::Constant)
         .export_values();
 
+    py::enum_<ButterworthFilter::FiltfiltBackend>(m, "FiltfiltBackend")
+        .value("Auto", ButterworthFilter::FiltfiltBackend::Auto)
+        .value("IIR", ButterworthFilter::FiltfiltBackend::IIR)
+        .value("FFT", ButterworthFilter::FiltfiltBackend::FFT)
+        .export_values();
+
+    // ----- ButterworthStream (流式滤波句柄) -----
+    py::class_<ButterworthFilter::Stream>(m, "ButterworthStream")
+        .def("process",
+             [](ButterworthFilter::Stream& self, const py::array& x, py::object out_obj) {
+                 auto [ptr, n] = as_ptr_len_1d(x);
+                 py::array out;
+                 if (out_obj.is_none()) out = py::array_t<double>((py::ssize_t)n);
+                 else out = out_obj.cast<py::array>();
+                 double* y = require_out_1d(out, n);
+                 self.process(ptr, y, n);
+                 return out;
+             },
+             py::arg("x"),
+             py::arg("out") = py::none(),
+             "滤波一个数据块, 状态在调用之间延续; out=x 时原地处理")
+        .def("reset", &ButterworthFilter::Stream::reset, "状态清零")
+        .def("prime", &ButterworthFilter::Stream::prime, py::arg("x0"),
+             "以稳态初始化: state = zi * x0")
+        .def_property("state",
+                      [](const ButterworthFilter::Stream& self) {
+                          std::vector<double> z = self.state();
+                          return vec_to_ndarray(std::move(z));
+                      },
+                      [](ButterworthFilter::Stream& self, const std::vector<double>& zi) {
+                          self.set_state(zi);
+                      },
+                      "当前延迟线状态 (与 lfilter 的 zi/zf 布局一致)");
+
+    // ----- ButterworthResampler (流式变采样率句柄) -----
+    py::class_<ButterworthFilter::Resampler>(m, "ButterworthResampler")
+        .def("process",
+             [](ButterworthFilter::Resampler& self, const py::array& x) {
+                 auto [ptr, n] = as_ptr_len_1d(x);
+                 // max_output 是精确值, 输出长度与 process 的返回值一致
+                 py::array_t<double> out((py::ssize_t)self.max_output(n));
+                 self.process(ptr, n, out.mutable_data());
+                 return out;
+             },
+             py::arg("x"),
+             "处理一个数据块, 返回这一块产生的输出样本; 状态与抽取相位在调用之间延续")
+        .def("max_output", &ButterworthFilter::Resampler::max_output, py::arg("n"),
+             "下一次处理 n 个输入样本会输出多少个")
+        .def("reset", &ButterworthFilter::Resampler::reset, "状态清零, 相位回到第一个样本");
+
+    // ----- ButterworthWorkspace (filtfilt 可复用的临时缓冲区) -----
+    py::class_<ButterworthFilter::Workspace>(m, "ButterworthWorkspace")
+        .def(py::init<>());
+
+    // ----- detrend (独立的去趋势模块, 可作为 filtfilt 之前的原地预处理) -----
+    // 不 export_values: Constant 与 PadType.Constant 同名
+    py::enum_<DetrendType>(m, "DetrendType")
+        .value("Linear", DetrendType::Linear)
+        .value("Constant", DetrendType::Constant);
+
+    m.def("detrend",
+          [](const py::array& x, DetrendType type, const std::vector<size_t>& bp, py::object out_obj) {
+              auto [ptr, n] = as_ptr_len_1d(x);
+              py::array out;
+              if (out_obj.is_none()) out = py::array_t<double>((py::ssize_t)n);
+              else out = out_obj.cast<py::array>();
+              double* y = require_out_1d(out, n);
+              detrend(ptr, n, y, type, bp);
+              return out;
+          },
+          py::arg("x"),
+          py::arg("type") = DetrendType::Linear,
+          py::arg("bp") = std::vector<size_t>{},
+          py::arg("out") = py::none(),
+          "去趋势 (同 scipy.signal.detrend), bp 为分段断点; out=x 时原地处理");
+
+    py::class_<SlidingDetrend>(m, "SlidingDetrend")
+        .def(py::init<size_t, DetrendType>(),
+             py::arg("window"),
+             py::arg("type") = DetrendType::Linear)
+        .def("process",
+             [](SlidingDetrend& self, const py::array& x, py::object out_obj) {
+                 auto [ptr, n] = as_ptr_len_1d(x);
+                 py::array out;
+                 if (out_obj.is_none()) out = py::array_t<double>((py::ssize_t)n);
+                 else out = out_obj.cast<py::array>();
+                 double* y = require_out_1d(out, n);
+                 self.process(ptr, y, n);
+                 return out;
+             },
+             py::arg("x"),
+             py::arg("out") = py::none(),
+             "滑动窗口去趋势一个数据块, 窗口在调用之间延续; out=x 时原地处理")
+        .def("reset", &SlidingDetrend::reset, "清空窗口")
+        .def_property_readonly("window", &SlidingDetrend::window);
+
     // ----- ButterworthFilter -----
     py::class_<ButterworthFilter>(m, "ButterworthFilter")
         // 构造函数 (转发到 from_ba)
@@ -129,26 +283,144 @@ PYBIND11_MODULE(butterworth_filter, m) {
                     py::arg("btype"),
                     py::arg("cutoff"),
                     py::arg("cache_zi") = true,
-                    "Create Butterworth filter from parameters")
+                    "Create Butterworth filter from parameters (designs are kept in a process-wide LRU cache)")
+
+        .def_static("antialias",
+                    &ButterworthFilter::antialias,
+                    py::arg("up"),
+                    py::arg("down"),
+                    py::arg("order") = 8,
+                    "Default anti-alias lowpass for resample_poly(up, down): cutoff 0.8 / max(up, down) of Nyquist")
+
+        .def_static("design_cache_info",
+                    []() {
+                        const auto st = ButterworthFilter::design_cache_stats();
+                        py::dict d;
+                        d["hits"] = st.hits;
+                        d["misses"] = st.misses;
+                        d["size"] = st.size;
+                        d["capacity"] = st.capacity;
+                        return d;
+                    },
+                    "from_params 设计缓存的命中/未命中计数与当前大小")
+
+        .def_static("set_design_cache_capacity",
+                    &ButterworthFilter::set_design_cache_capacity,
+                    py::arg("capacity"),
+                    "设置设计缓存容量, 0 表示关闭")
+
+        .def_static("clear_design_cache",
+                    &ButterworthFilter::clear_design_cache,
+                    "清空设计缓存并把计数清零")
 
         // ========== numpy zero-copy main APIs ==========
         .def("filtfilt",
              [](const ButterworthFilter& self,
                 const py::array& x,
                 ButterworthFilter::PadType padtype,
-                int padlen) {
+                int padlen,
+                int axis,
+                py::object out_obj,
+                ButterworthFilter::Workspace* ws,
+                bool coeff_double,
+                ButterworthFilter::FiltfiltBackend backend,
+                int num_threads) {
+                 // FFT 后端与多线程只在一维 float64 的 vector 实现里有; 别的路径不能悄悄退回单线程 IIR
+                 const bool wants_backend = backend == ButterworthFilter::FiltfiltBackend::FFT || num_threads > 1;
+                 if (wants_backend && (x.ndim() == 2 || is_f32(x) || ws))
+                     throw std::invalid_argument(
+                         "backend=FFT and num_threads > 1 are only supported for 1D float64 x without workspace");
+                 if (x.ndim() == 2) {
+                     // 多通道: 沿 axis 滤波, 各通道在 SIMD lane 中并行
+                     if (!out_obj.is_none() || ws)
+                         throw std::invalid_argument("out/workspace are only supported for 1D x");
+                     require_2d_data_f64(x);
+                     const auto rows = (size_t)x.shape(0), cols = (size_t)x.shape(1);
+                     auto y = self.filtfilt_multi(static_cast<const double*>(x.data()), rows, cols,
+                                                  axis, padtype, padlen);
+                     return vec_to_ndarray_2d(std::move(y), rows, cols);
+                 }
+                 if (is_f32(x)) {
+                     // float32 入口: 输出也是 float32, 不经过 float64 转换
+                     auto [ptr, n] = as_ptr_len_1d<float>(x);
+                     py::array out;
+                     if (out_obj.is_none()) out = py::array_t<float>((py::ssize_t)n);
+                     else out = out_obj.cast<py::array>();
+                     float* y = require_out_1d<float>(out, n);
+                     ButterworthFilter::Workspace local;
+                     self.filtfilt(ptr, n, y, ws ? *ws : local, padtype, padlen, coeff_double);
+                     return out;
+                 }
                  auto [ptr, n] = as_ptr_len_1d(x);
-                 auto y = self.filtfilt(ptr, n, padtype, padlen);
-                 return vec_to_ndarray(std::move(y));
+                 if ((out_obj.is_none() && !ws) || wants_backend) {
+                     // 默认 IIR, 与之前的结果逐位相同; Auto 需显式指定
+                     std::vector<double> y;
+                     {
+                         py::gil_scoped_release release;
+                         y = self.filtfilt(ptr, n, padtype, padlen, backend, num_threads);
+                     }
+                     if (out_obj.is_none()) return vec_to_ndarray(std::move(y));
+                     // 指定了 FFT / 多线程又给了 out: 结果拷进 out (可以就是 x)
+                     py::array out = out_obj.cast<py::array>();
+                     std::copy(y.begin(), y.end(), require_out_1d(out, n));
+                     return out;
+                 }
+                 // 直接写入 out (可以就是 x), 临时缓冲区取自 workspace, 反复调用时不再分配
+                 py::array out;
+                 if (out_obj.is_none()) out = py::array_t<double>((py::ssize_t)n);
+                 else out = out_obj.cast<py::array>();
+                 double* y = require_out_1d(out, n);
+                 ButterworthFilter::Workspace local;
+                 self.filtfilt(ptr, n, y, ws ? *ws : local, padtype, padlen);
+                 return out;
              },
              py::arg("x"),
              py::arg("padtype") = ButterworthFilter::PadType::Odd,
-             py::arg("padlen") = -1)
+             py::arg("padlen") = -1,
+             py::arg("axis") = -1,
+             py::arg("out") = py::none(),
+             py::arg("workspace") = nullptr,
+             py::arg("coeff_double") = true,
+             py::arg("backend") = ButterworthFilter::FiltfiltBackend::IIR,
+             py::arg("num_threads") = 1,
+             "零相位滤波; 一维 float32 输入返回 float32, coeff_double=True 时系数与递推保持 double. "
+             "一维 float64 且不带 out/workspace 时按 backend 选 IIR 或 FFT (|H|^2 overlap-save) 实现, "
+             "默认 IIR, Auto 按信号长度、状态数与冲激响应长度估算耗时, FFT 明显更快时才选它, num_threads 为 FFT 分块/时间并行的线程数. "
+             "out/workspace 路径固定走单线程 IIR; 给了 out 又指定 backend=FFT 或 num_threads > 1 时先算好再拷进 out, "
+             "与 workspace、float32 或二维输入同时指定则抛 ValueError")
 
         .def("lfilter",
              [](const ButterworthFilter& self,
                 const py::array& x,
-                py::object zi_obj) {
+                py::object zi_obj,
+                int axis,
+                bool coeff_double) {
+                 if (x.ndim() == 2) {
+                     // 多通道: zi/zf 形状为 (channels, state_size)
+                     require_2d_data_f64(x);
+                     const auto rows = (size_t)x.shape(0), cols = (size_t)x.shape(1);
+                     const size_t channels = axis == 0 ? cols : rows;
+                     std::vector<double> zi, zf;
+                     if (!zi_obj.is_none()) {
+                         auto zi_arr = py::array_t<double, py::array::c_style | py::array::forcecast>::ensure(zi_obj);
+                         if (!zi_arr) throw std::invalid_argument("zi must be array-like");
+                         zi.assign(zi_arr.data(), zi_arr.data() + zi_arr.size());
+                     }
+                     auto y = self.lfilter_multi(static_cast<const double*>(x.data()), rows, cols, axis,
+                                                 zi_obj.is_none() ? nullptr : &zi, &zf);
+                     return py::make_tuple(vec_to_ndarray_2d(std::move(y), rows, cols),
+                                           vec_to_ndarray_2d(std::move(zf), channels, self.state_size()));
+                 }
+
+                 if (is_f32(x)) {
+                     auto [ptr, n] = as_ptr_len_1d<float>(x);
+                     std::vector<float> zi;
+                     if (!zi_obj.is_none()) zi = zi_obj.cast<std::vector<float>>();
+                     auto yz = self.lfilter(ptr, n, zi_obj.is_none() ? nullptr : &zi, coeff_double);
+                     return py::make_tuple(vec_to_ndarray(std::move(yz.first)),
+                                           vec_to_ndarray(std::move(yz.second)));
+                 }
+
                  auto [ptr, n] = as_ptr_len_1d(x);
 
                  if (zi_obj.is_none()) {
@@ -164,7 +436,219 @@ PYBIND11_MODULE(butterworth_filter, m) {
                                        vec_to_ndarray(std::move(yz.second)));
              },
              py::arg("x"),
-             py::arg("zi") = py::none())
+             py::arg("zi") = py::none(),
+             py::arg("axis") = -1,
+             py::arg("coeff_double") = true)
+
+        .def("filtfilt_batch",
+             [](const ButterworthFilter& self,
+                const py::object& x_obj,
+                const py::object& offsets_obj,
+                ButterworthFilter::PadType padtype,
+                int padlen,
+                int num_threads) -> py::object {
+                 if (offsets_obj.is_none()) {
+                     // list[np.ndarray]: 逐个检查并预先分配输出, 之后释放 GIL 多线程计算
+                     py::sequence seq = x_obj.cast<py::sequence>();
+                     const size_t count = (size_t)py::len(seq);
+                     std::vector<py::array> inputs, outputs;
+                     std::vector<const double*> xs(count);
+                     std::vector<double*> ys(count);
+                     std::vector<size_t> lens(count);
+                     inputs.reserve(count);
+                     outputs.reserve(count);
+                     for (size_t i = 0; i < count; ++i) {
+                         inputs.push_back(seq[i].cast<py::array>());
+                         auto [ptr, n] = as_ptr_len_1d(inputs.back());
+                         outputs.push_back(py::array_t<double>((py::ssize_t)n));
+                         xs[i] = ptr;
+                         lens[i] = n;
+                         ys[i] = static_cast<double*>(outputs.back().request(true).ptr);
+                     }
+                     {
+                         py::gil_scoped_release release;
+                         self.filtfilt_batch(xs.data(), lens.data(), count, ys.data(),
+                                             padtype, padlen, num_threads);
+                     }
+                     py::list result;
+                     for (auto& out : outputs) result.append(out);
+                     return std::move(result);
+                 }
+
+                 // 拼接缓冲区 + offsets (长度 count + 1), 输出与 x 同布局
+                 py::array x = x_obj.cast<py::array>();
+                 auto [ptr, n] = as_ptr_len_1d(x);
+                 auto off = py::array_t<int64_t, py::array::c_style | py::array::forcecast>::ensure(offsets_obj);
+                 if (!off || off.ndim() != 1 || off.size() < 1)
+                     throw std::invalid_argument("offsets must be a 1D integer array of length count + 1");
+                 const size_t count = (size_t)off.size() - 1;
+                 std::vector<size_t> offsets(count + 1);
+                 for (size_t i = 0; i <= count; ++i) {
+                     const int64_t o = off.data()[i];
+                     if (o < 0 || (size_t)o > n)
+                         throw std::invalid_argument("offsets out of range");
+                     offsets[i] = (size_t)o;
+                 }
+                 py::array_t<double> out((py::ssize_t)n);
+                 double* y = static_cast<double*>(out.request(true).ptr);
+                 // 不属于任何信号的样本原样保留
+                 std::copy(ptr, ptr + n, y);
+                 {
+                     py::gil_scoped_release release;
+                     self.filtfilt_batch(ptr, offsets.data(), count, y, padtype, padlen, num_threads);
+                 }
+                 return std::move(out);
+             },
+             py::arg("x"),
+             py::arg("offsets") = py::none(),
+             py::arg("padtype") = ButterworthFilter::PadType::Odd,
+             py::arg("padlen") = -1,
+             py::arg("num_threads") = 0,
+             "批量 filtfilt: x 为一维数组列表 (返回列表), 或拼接缓冲区 + offsets (返回同布局数组);\n"
+             "计算期间释放 GIL, num_threads <= 0 时使用全部硬件线程")
+
+        .def("lfilter_parallel",
+             [](const ButterworthFilter& self, const py::array& x, py::object zi_obj, int num_threads) {
+                 auto [ptr, n] = as_ptr_len_1d(x);
+                 std::vector<double> zi;
+                 const std::vector<double>* pzi = nullptr;
+                 if (!zi_obj.is_none()) {
+                     zi = zi_obj.cast<std::vector<double>>();
+                     pzi = &zi;
+                 }
+                 std::pair<std::vector<double>, std::vector<double>> res;
+                 {
+                     py::gil_scoped_release release;
+                     res = self.lfilter_parallel(ptr, n, pzi, num_threads);
+                 }
+                 return py::make_tuple(vec_to_ndarray(std::move(res.first)),
+                                       vec_to_ndarray(std::move(res.second)));
+             },
+             py::arg("x"),
+             py::arg("zi") = py::none(),
+             py::arg("num_threads") = 0,
+             "时间并行 lfilter: 分块并行滤波后用状态转移矩阵修正各块开头, 返回 (y, zf);\n"
+             "与 lfilter 之差为舍入误差量级, 随截止频率降低而增大 (相对 max|y|: 归一化截止 0.02 约 3e-14,\n"
+             "0.002 约 1e-12, 0.0002 约 1e-11); 适合 10^7 以上样本的超长信号")
+
+        .def("filtfilt_parallel",
+             [](const ButterworthFilter& self, const py::array& x,
+                ButterworthFilter::PadType padtype, int padlen, int num_threads) {
+                 auto [ptr, n] = as_ptr_len_1d(x);
+                 std::vector<double> y;
+                 {
+                     py::gil_scoped_release release;
+                     y = self.filtfilt_parallel(ptr, n, padtype, padlen, num_threads);
+                 }
+                 return vec_to_ndarray(std::move(y));
+             },
+             py::arg("x"),
+             py::arg("padtype") = ButterworthFilter::PadType::Odd,
+             py::arg("padlen") = -1,
+             py::arg("num_threads") = 0,
+             "时间并行 filtfilt, 正反两遍都按块并行; 与 filtfilt 之差与 lfilter_parallel 同量级, 最差约 1.5e-11")
+
+        .def("decimate",
+             [](const ButterworthFilter& self, const py::array& x, int q, bool zero_phase,
+                ButterworthFilter::PadType padtype, int padlen) {
+                 auto [ptr, n] = as_ptr_len_1d(x);
+                 std::vector<double> y;
+                 {
+                     py::gil_scoped_release release;
+                     y = self.decimate(ptr, n, q, zero_phase, padtype, padlen);
+                 }
+                 return vec_to_ndarray(std::move(y));
+             },
+             py::arg("x"),
+             py::arg("q"),
+             py::arg("zero_phase") = true,
+             py::arg("padtype") = ButterworthFilter::PadType::Odd,
+             py::arg("padlen") = -1,
+             "抗混叠滤波 + q 倍抽取, 只输出保留的样本; zero_phase=True 时等于 filtfilt(x)[::q]")
+
+        .def("resample_poly",
+             [](const ButterworthFilter& self, const py::array& x, int up, int down, bool zero_phase,
+                ButterworthFilter::PadType padtype, int padlen) {
+                 auto [ptr, n] = as_ptr_len_1d(x);
+                 std::vector<double> y;
+                 {
+                     py::gil_scoped_release release;
+                     y = self.resample_poly(ptr, n, up, down, zero_phase, padtype, padlen);
+                 }
+                 return vec_to_ndarray(std::move(y));
+             },
+             py::arg("x"),
+             py::arg("up"),
+             py::arg("down"),
+             py::arg("zero_phase") = true,
+             py::arg("padtype") = ButterworthFilter::PadType::Odd,
+             py::arg("padlen") = -1,
+             "按 up/down 变采样率: 零插值 -> 抗混叠滤波 (工作在 up*fs 速率) -> 每 down 个取一个, "
+             "输出 ceil(len(x)*up/down) 个样本")
+
+        .def("resampler",
+             &ButterworthFilter::resampler,
+             py::arg("up"),
+             py::arg("down"),
+             "创建流式变采样率句柄 (ButterworthResampler), 因果滤波, 初始状态为零")
+
+        .def("freqz",
+             [](const ButterworthFilter& self, py::object worN, bool whole, double fs) {
+                 ButterworthFilter::FrequencyResponse r;
+                 if (py::isinstance<py::int_>(worN)) {
+                     r = self.freqz(worN.cast<size_t>(), whole, fs);
+                 } else {
+                     auto w = py::array_t<double, py::array::c_style | py::array::forcecast>::ensure(worN);
+                     if (!w || w.ndim() != 1) throw std::invalid_argument("worN must be an int or a 1D array of frequencies");
+                     r = self.freqz(w.data(), (size_t)w.size(), fs);
+                 }
+                 return response_to_tuple(std::move(r));
+             },
+             py::arg("worN") = 512,
+             py::arg("whole") = false,
+             py::arg("fs") = 6.283185307179586,
+             "频率响应 (同 scipy.signal.freqz + group_delay), 返回 (w, magnitude, phase, group_delay); "
+             "worN 为点数或频点数组, 单位与 fs 相同, 群延迟单位为样本")
+
+        .def("sosfreqz",
+             [](const ButterworthFilter& self, py::object worN, bool whole, double fs) {
+                 ButterworthFilter::FrequencyResponse r;
+                 if (py::isinstance<py::int_>(worN)) {
+                     r = self.sosfreqz(worN.cast<size_t>(), whole, fs);
+                 } else {
+                     auto w = py::array_t<double, py::array::c_style | py::array::forcecast>::ensure(worN);
+                     if (!w || w.ndim() != 1) throw std::invalid_argument("worN must be an int or a 1D array of frequencies");
+                     r = self.sosfreqz(w.data(), (size_t)w.size(), fs);
+                 }
+                 return response_to_tuple(std::move(r));
+             },
+             py::arg("worN") = 512,
+             py::arg("whole") = false,
+             py::arg("fs") = 6.283185307179586,
+             "同 freqz, 但要求滤波器是 SOS 模式 (同 scipy.signal.sosfreqz)")
+
+        .def_property_readonly("sos",
+                               [](const ButterworthFilter& self) {
+                                   const auto& sos = self.sos();
+                                   std::vector<double> flat;
+                                   flat.reserve(sos.size() * 6);
+                                   for (const auto& s : sos) flat.insert(flat.end(), s.begin(), s.end());
+                                   return vec_to_ndarray_2d(std::move(flat), sos.size(), 6);
+                               },
+                               "归一化后的二阶节 (n_sections, 6), BA 模式下为空")
+
+        .def("state_size",
+             &ButterworthFilter::state_size,
+             "单通道延迟线长度, 多通道 lfilter 的 zi/zf 形状为 (channels, state_size)")
+
+        .def("workspace",
+             &ButterworthFilter::workspace,
+             py::arg("max_len") = 0,
+             "创建 filtfilt 的可复用临时缓冲区, 按最长 max_len 个样本预分配")
+
+        .def("stream",
+             &ButterworthFilter::stream,
+             "创建流式滤波句柄 (ButterworthStream), 初始状态为零")
 
         .def("detrend",
              [](const ButterworthFilter& self, const py::array& x) {
@@ -1,11 +1,37 @@
 #include "butterworth_filter.h"
+#include "detrend.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <complex>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace {
 
+// 库以 -ffast-math 编译, std::isfinite / NaN 比较可能被优化掉; 直接看指数位 (全 1 为 Inf/NaN)
+static bool is_finite_bits(double x) {
+    uint64_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    return (u & 0x7ff0000000000000ull) != 0x7ff0000000000000ull;
+}
+
 static std::vector<double> pad_to_len(const std::vector<double>& v, int n) {
     if ((int)v.size() >= n) return v;
     std::vector<double> out = v;
@@ -61,6 +87,439 @@ static std::vector<double> solve_linear(const std::vector<double>& A,
     return x;
 }
 
+// Workspace 里与样本类型 T 对应的那块缓冲区
+template <class T>
+static std::vector<T>& workspace_buffer(std::vector<double>& d, std::vector<float>& f) {
+    if constexpr (std::is_same<T, float>::value) return f;
+    else return d;
+}
+
+// num_threads <= 0 时取硬件线程数, 至少 1
+static size_t thread_count(int num_threads) {
+    const size_t hw = std::thread::hardware_concurrency();
+    return std::max<size_t>(1, num_threads > 0 ? (size_t)num_threads : hw);
+}
+
+// 在 workers 个线程上各执行一次 fn(t), t = 0 在调用线程上执行
+template <class F>
+static void run_workers(size_t workers, F&& fn) {
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (size_t t = 1; t < workers; ++t) pool.emplace_back([&fn, t]() { fn(t); });
+    fn(0);
+    for (auto& th : pool) th.join();
+}
+
+// 方阵乘法 C = A * B, 行主序 n x n
+static std::vector<double> mat_mul(const std::vector<double>& A, const std::vector<double>& B, size_t n) {
+    std::vector<double> C(n * n, 0.0);
+    for (size_t r = 0; r < n; ++r)
+        for (size_t k = 0; k < n; ++k) {
+            const double v = A[r * n + k];
+            if (v == 0.0) continue;
+            for (size_t c = 0; c < n; ++c) C[r * n + c] += v * B[k * n + c];
+        }
+    return C;
+}
+
+// A^p, 反复平方
+static std::vector<double> mat_pow(std::vector<double> A, size_t p, size_t n) {
+    std::vector<double> R(n * n, 0.0);
+    for (size_t i = 0; i < n; ++i) R[i * n + i] = 1.0;
+    for (; p > 0; p >>= 1) {
+        if (p & 1) R = mat_mul(R, A, n);
+        if (p > 1) A = mat_mul(A, A, n);
+    }
+    return R;
+}
+
+// 块并行: 每块至少这么多样本, 否则线程开销盖过收益
+constexpr size_t kMinParallelChunk = (size_t)1 << 16;
+// 零输入响应每算这么多个样本检查一次状态是否已衰减到可忽略
+constexpr size_t kFixBlock = 64;
+// 状态的无穷范数降到初始状态的这个倍数以下即视为衰减完
+constexpr double kTransientTol = 1e-18;
+
+// ---- FFT 零相位后端 ----
+// 冲激响应截断: 尾部 (由剩余状态界定) 降到峰值的这个倍数以下为止
+constexpr double kImpulseTol = 1e-16;
+// 冲激响应超过这么长 (极点太靠近单位圆) 时不走 FFT
+constexpr size_t kMaxImpulseLen = (size_t)1 << 20;
+// 自动选择时, 信号短于这个长度一律走 IIR
+constexpr size_t kMinFftLen = (size_t)1 << 15;
+// Auto 的耗时模型 (ns, -O3 -march=native 单线程实测标定, 只用来比大小; IIR 取偏低的估计, 拿不准时选 IIR):
+// IIR filtfilt 每样本 kIirCostBase + kIirCostPerState * state_size();
+// FFT 每个 N 点块变换 (含取数与乘 |H|^2) kFftCost * N * log2(N), 另有每次调用都要付的
+// FftPlan 构造 (每点 kFftPlanCost) 与 |H|^2 频谱、右端重算这些固定开销, 短信号上不可忽略
+constexpr double kFftCost = 2.7;
+constexpr double kFftPlanCost = 16.0;
+constexpr double kIirCostBase = 8.0;
+constexpr double kIirCostPerState = 1.6;
+
+// 迭代 radix-2 复数 FFT, n 为 2 的幂. 旋转因子与位反转表预先算好, 可在多个线程间共享只读
+struct FftPlan {
+    size_t n = 0;
+    std::vector<std::complex<double>> tw;   // exp(-2*pi*i*k/n), k < n/2
+    std::vector<size_t> rev;
+
+    explicit FftPlan(size_t size) : n(size), tw(size / 2), rev(size) {
+        const double pi = std::acos(-1.0);
+        for (size_t k = 0; k < n / 2; ++k)
+            tw[k] = std::polar(1.0, -2.0 * pi * (double)k / (double)n);
+        size_t bits = 0;
+        while (((size_t)1 << bits) < n) ++bits;
+        for (size_t i = 0; i < n; ++i) {
+            size_t r = 0;
+            for (size_t b = 0; b < bits; ++b) r |= ((i >> b) & 1u) << (bits - 1 - b);
+            rev[i] = r;
+        }
+    }
+
+    // inverse 时不做 1/n 归一化
+    void run(std::complex<double>* a, bool inverse) const {
+        for (size_t i = 0; i < n; ++i)
+            if (i < rev[i]) std::swap(a[i], a[rev[i]]);
+        for (size_t len = 2; len <= n; len <<= 1) {
+            const size_t half = len / 2;
+            const size_t step = n / len;
+            for (size_t i = 0; i < n; i += len) {
+                for (size_t j = 0; j < half; ++j) {
+                    const std::complex<double> w = inverse ? std::conj(tw[j * step]) : tw[j * step];
+                    const std::complex<double> u = a[i + j];
+                    const std::complex<double> v = a[i + j + half] * w;
+                    a[i + j] = u + v;
+                    a[i + j + half] = u - v;
+                }
+            }
+        }
+    }
+};
+
+static size_t next_pow2(size_t v) {
+    size_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+// overlap-save 的块长 N: 至少 8M (有效比例 L / N >= 3/4) 且不小于 4096, 但不超过一块装下整段信号所需
+static size_t fft_block_len(size_t n, size_t M) {
+    return std::min(next_pow2(std::max(8 * M, (size_t)4096)), next_pow2(n + 2 * (M - 1)));
+}
+
+// filtfilt_fft 对长 n 的信号、长 M 的冲激响应的估计耗时 (ns), 与其实现一一对应
+static double fft_filtfilt_cost(size_t n, size_t M) {
+    const size_t N = fft_block_len(n, M);
+    const size_t L = N - 2 * (M - 1);
+    const size_t pairs = ((n + L - 1) / L + 1) / 2;
+    const size_t Nt = next_pow2(2 * M - 1);
+    const double lgN = std::log2((double)N), lgNt = std::log2((double)Nt);
+    // 每对块正反两次变换, 外加 |H|^2 频谱一次; 右端重算三次 Nt 点变换; 两个 FftPlan
+    return kFftCost * ((double)(2 * pairs + 1) * (double)N * lgN + 3.0 * (double)Nt * lgNt)
+         + kFftPlanCost * (double)(N + Nt);
+}
+
+// ---- 多通道 lane 内核 ----
+// 缓冲区为时间主序, 第 k 个时间点的 C 个通道连续, 相邻时间点相隔 ts (可为负, 用于原地反向滤波);
+// 状态布局 z[j * C + c], 即每个状态量的 C 个通道相邻.
+// 递推沿时间无法向量化, 但通道之间互相独立: 每个 SIMD 寄存器装 Lanes::width 个通道.
+
+// 目标平台最宽的 double 向量: AVX 4 通道, aarch64 NEON 2 通道, 否则退化为标量
+struct Lanes {
+#if defined(__AVX__)
+    using reg = __m256d;
+    static constexpr size_t width = 4;
+    static reg load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, reg v) { _mm256_storeu_pd(p, v); }
+    static reg set1(double v) { return _mm256_set1_pd(v); }
+    static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    using reg = float64x2_t;
+    static constexpr size_t width = 2;
+    static reg load(const double* p) { return vld1q_f64(p); }
+    static void store(double* p, reg v) { vst1q_f64(p, v); }
+    static reg set1(double v) { return vdupq_n_f64(v); }
+    static reg add(reg a, reg b) { return vaddq_f64(a, b); }
+    static reg sub(reg a, reg b) { return vsubq_f64(a, b); }
+    static reg mul(reg a, reg b) { return vmulq_f64(a, b); }
+    static reg div(reg a, reg b) { return vdivq_f64(a, b); }
+#else
+    using reg = double;
+    static constexpr size_t width = 1;
+    static reg load(const double* p) { return *p; }
+    static void store(double* p, reg v) { *p = v; }
+    static reg set1(double v) { return v; }
+    static reg add(reg a, reg b) { return a + b; }
+    static reg sub(reg a, reg b) { return a - b; }
+    static reg mul(reg a, reg b) { return a * b; }
+    static reg div(reg a, reg b) { return a / b; }
+#endif
+};
+
+// 一组通道 = R 个寄存器, R 条互不相关的递推链交错执行, 填满乘加单元的流水线.
+// SOS 的状态全程在寄存器里, 一组 3 个 (AVX 下 12 通道, 正好一组 IMU);
+// BA 的状态要经过内存, 链多了反而拖慢, 一组 2 个.
+constexpr size_t kSosRegs = 3;
+constexpr size_t kBaRegs = 2;
+constexpr size_t kSosLanes = kSosRegs * Lanes::width;
+constexpr size_t kBaLanes = kBaRegs * Lanes::width;
+// 时间分块长度, 一块 (kBlock, 一组通道) 的缓冲区留在 L1 里
+constexpr size_t kBlock = 256;
+
+// ---- 频率响应 ----
+// 一个寄存器装 Lanes::width 个频点, 复数的实部、虚部分开放在两个寄存器里.
+// 求 P(z) = sum p[k] z^k 与 Q(z) = z P'(z) = sum k p[k] z^k, z = e^{-jw}: Horner 同时推进 P 与 P'
+static inline void poly_response_lanes(const double* p, size_t deg, Lanes::reg zr, Lanes::reg zi,
+                                       Lanes::reg& pr, Lanes::reg& pi,
+                                       Lanes::reg& qr, Lanes::reg& qi) {
+    using L = Lanes;
+    pr = L::set1(p[deg]);
+    pi = L::set1(0.0);
+    L::reg dr = L::set1(0.0), di = L::set1(0.0);
+    for (size_t k = deg; k-- > 0;) {
+        const L::reg ndr = L::add(L::sub(L::mul(dr, zr), L::mul(di, zi)), pr);
+        const L::reg ndi = L::add(L::add(L::mul(dr, zi), L::mul(di, zr)), pi);
+        const L::reg npr = L::add(L::sub(L::mul(pr, zr), L::mul(pi, zi)), L::set1(p[k]));
+        const L::reg npi = L::add(L::mul(pr, zi), L::mul(pi, zr));
+        dr = ndr; di = ndi;
+        pr = npr; pi = npi;
+    }
+    qr = L::sub(L::mul(dr, zr), L::mul(di, zi));
+    qi = L::add(L::mul(dr, zi), L::mul(di, zr));
+}
+
+// P 的群延迟 Re(Q / P) = Re(Q conj(P)) / |P|^2 (单位: 样本).
+// P 恰为零 (零点落在单位圆上) 时分子也为零, 分母加上最小正规数后结果记 0, 同 scipy.signal.group_delay
+static inline Lanes::reg poly_delay_lanes(Lanes::reg pr, Lanes::reg pi, Lanes::reg qr, Lanes::reg qi) {
+    using L = Lanes;
+    const L::reg num = L::add(L::mul(qr, pr), L::mul(qi, pi));
+    const L::reg den = L::add(L::add(L::mul(pr, pr), L::mul(pi, pi)),
+                              L::set1(std::numeric_limits<double>::min()));
+    return L::div(num, den);
+}
+
+// 复数乘法 (ar + j ai) *= (br + j bi)
+static inline void cmul_lanes(Lanes::reg& ar, Lanes::reg& ai, Lanes::reg br, Lanes::reg bi) {
+    using L = Lanes;
+    const L::reg r = L::sub(L::mul(ar, br), L::mul(ai, bi));
+    ai = L::add(L::mul(ar, bi), L::mul(ai, br));
+    ar = r;
+}
+
+// 一组 W 个通道在缓冲区之间搬运. 循环长度固定为 W, 不足一组时按 w 截断;
+// 不写成 std::copy(src, src + w, dst), 否则每个时间点都是一次 memmove 调用
+template <size_t W>
+static inline void copy_lanes(const double* src, double* dst, size_t w) {
+    if (w == W) {
+        for (size_t l = 0; l < W; ++l) dst[l] = src[l];
+    } else {
+        for (size_t l = 0; l < W; ++l)
+            if (l < w) dst[l] = src[l];
+    }
+}
+
+// x 的 m 个时间点 x w 个通道 (元素 (k, l) 在 x[k * ts + l * cs]) 读进 buf 的一块 (m, W).
+// 通道连续 (cs == 1) 时逐时间点整行拷贝; 否则是每通道一段连续时间 (axis = 1),
+// 逐通道顺序读、按列写进 L1 里的 buf, 只转置这一块而不是整个数组
+template <size_t W>
+static inline void load_tile(const double* x, std::ptrdiff_t ts, std::ptrdiff_t cs,
+                             size_t m, size_t w, double* buf) {
+    if (cs == 1) {
+        for (size_t k = 0; k < m; ++k) copy_lanes<W>(x + (std::ptrdiff_t)k * ts, buf + k * W, w);
+        return;
+    }
+    for (size_t l = 0; l < w; ++l) {
+        const double* xl = x + (std::ptrdiff_t)l * cs;
+        for (size_t k = 0; k < m; ++k) buf[k * W + l] = xl[(std::ptrdiff_t)k * ts];
+    }
+}
+
+// load_tile 的反方向
+template <size_t W>
+static inline void store_tile(const double* buf, size_t m, size_t w,
+                              double* y, std::ptrdiff_t ts, std::ptrdiff_t cs) {
+    if (cs == 1) {
+        for (size_t k = 0; k < m; ++k) copy_lanes<W>(buf + k * W, y + (std::ptrdiff_t)k * ts, w);
+        return;
+    }
+    for (size_t l = 0; l < w; ++l) {
+        double* yl = y + (std::ptrdiff_t)l * cs;
+        for (size_t k = 0; k < m; ++k) yl[(std::ptrdiff_t)k * ts] = buf[k * W + l];
+    }
+}
+
+// 一个二阶节在 buf 的 m 个时间点上原地滤波, 一组 kSosLanes 个通道, 状态 pz1/pz2 各一组.
+// 把 y 代入状态更新: z1' = c1 * x + z2 - a1 * z1, z2' = c2 * x - a2 * z1,
+// 递推链上只剩 z1 -> z1' 一次乘加, 不必等 y 算完.
+static void sos_section_lanes(const ButterworthFilter::SOSSection& s,
+                              double* buf, size_t m, double* pz1, double* pz2) {
+    using L = Lanes;
+    const double c1 = s[1] - s[4] * s[0], c2 = s[2] - s[5] * s[0];
+    const L::reg b0 = L::set1(s[0]), a1 = L::set1(s[4]), a2 = L::set1(s[5]);
+    const L::reg vc1 = L::set1(c1), vc2 = L::set1(c2);
+    L::reg z1[kSosRegs], z2[kSosRegs];
+    for (size_t r = 0; r < kSosRegs; ++r) {
+        z1[r] = L::load(pz1 + r * L::width);
+        z2[r] = L::load(pz2 + r * L::width);
+    }
+    for (size_t k = 0; k < m; ++k) {
+        double* row = buf + k * kSosLanes;
+        for (size_t r = 0; r < kSosRegs; ++r) {
+            const L::reg xi = L::load(row + r * L::width);
+            const L::reg zp = z1[r];
+            L::store(row + r * L::width, L::add(L::mul(b0, xi), zp));
+            z1[r] = L::sub(L::add(L::mul(vc1, xi), z2[r]), L::mul(a1, zp));
+            z2[r] = L::sub(L::mul(vc2, xi), L::mul(a2, zp));
+        }
+    }
+    for (size_t r = 0; r < kSosRegs; ++r) {
+        L::store(pz1 + r * L::width, z1[r]);
+        L::store(pz2 + r * L::width, z2[r]);
+    }
+}
+
+// w (<= kSosLanes) 个通道走完整个级联, 不足一组的部分补 0 通道.
+// 时间分块, 块内逐节走完再进入下一节: 每节只有 2 * kSosRegs 个状态寄存器和 5 个系数, 全程不落内存.
+static void sos_lanes(const ButterworthFilter::SOSSection* sos, int nsec,
+                      const double* x, double* y, size_t n, std::ptrdiff_t ts, std::ptrdiff_t cs,
+                      double* z, size_t C, size_t w) {
+    constexpr size_t W = kSosLanes;
+    // 本组状态搬成连续的 (2 * nsec, W)
+    std::vector<double> zs((size_t)(2 * nsec) * W, 0.0);
+    for (size_t j = 0; j < (size_t)(2 * nsec); ++j)
+        std::copy(z + j * C, z + j * C + w, zs.data() + j * W);
+
+    double buf[kBlock * W] = {};
+    for (size_t k0 = 0; k0 < n; k0 += kBlock) {
+        const size_t m = std::min(kBlock, n - k0);
+        load_tile<W>(x + (std::ptrdiff_t)k0 * ts, ts, cs, m, w, buf);
+        for (int si = 0; si < nsec; ++si) {
+            double* pz1 = zs.data() + (size_t)(2 * si) * W;
+            sos_section_lanes(sos[si], buf, m, pz1, pz1 + W);
+        }
+        store_tile<W>(buf, m, w, y + (std::ptrdiff_t)k0 * ts, ts, cs);
+    }
+
+    for (size_t j = 0; j < (size_t)(2 * nsec); ++j)
+        std::copy(zs.data() + j * W, zs.data() + j * W + w, z + j * C);
+}
+
+// 传递函数形式不能拆节, 逐时间点走完全部状态; 状态放在连续的 (order + 1, kBaLanes) 里,
+// 多留一行 0, 使最后一个状态量与其余状态量同一写法.
+static void ba_lanes(const double* b, const double* a, int order,
+                     const double* x, double* y, size_t n, std::ptrdiff_t ts, std::ptrdiff_t cs,
+                     double* z, size_t C, size_t w) {
+    using L = Lanes;
+    constexpr size_t W = kBaLanes;
+    std::vector<double> zs((size_t)(order + 1) * W, 0.0);
+    for (size_t j = 0; j < (size_t)order; ++j)
+        std::copy(z + j * C, z + j * C + w, zs.data() + j * W);
+
+    const L::reg b0 = L::set1(b[0]);
+    double buf[kBlock * W] = {};
+    for (size_t k0 = 0; k0 < n; k0 += kBlock) {
+        const size_t m = std::min(kBlock, n - k0);
+        load_tile<W>(x + (std::ptrdiff_t)k0 * ts, ts, cs, m, w, buf);
+        for (size_t k = 0; k < m; ++k) {
+            double* row = buf + k * W;
+            for (size_t r = 0; r < kBaRegs; ++r) {
+                const size_t o = r * L::width;
+                const L::reg xi = L::load(row + o);
+                const L::reg yi = L::add(L::mul(b0, xi), L::load(zs.data() + o));
+                for (int i = 0; i < order; ++i) {
+                    double* pz = zs.data() + (size_t)i * W + o;
+                    const L::reg t = L::add(L::load(pz + W), L::mul(L::set1(b[i + 1]), xi));
+                    L::store(pz, L::sub(t, L::mul(L::set1(a[i + 1]), yi)));
+                }
+                L::store(row + o, yi);
+            }
+        }
+        store_tile<W>(buf, m, w, y + (std::ptrdiff_t)k0 * ts, ts, cs);
+    }
+
+    for (size_t j = 0; j < (size_t)order; ++j)
+        std::copy(zs.data() + j * W, zs.data() + j * W + w, z + j * C);
+}
+
+// 只剩一个通道时补满一组并不划算, 单独走标量递推, 写法与 sosfilt_df2t_raw / lfilter_df2t_raw 相同
+static void sos_single(const ButterworthFilter::SOSSection* sos, int nsec,
+                       const double* x, double* y, size_t n, std::ptrdiff_t ts,
+                       double* z, size_t C) {
+    std::vector<double> zc((size_t)(2 * nsec));
+    for (size_t j = 0; j < zc.size(); ++j) zc[j] = z[j * C];
+    for (size_t k = 0; k < n; ++k) {
+        double xi = x[(std::ptrdiff_t)k * ts];
+        for (int si = 0; si < nsec; ++si) {
+            const auto& s = sos[si];
+            double& z1 = zc[2 * si];
+            double& z2 = zc[2 * si + 1];
+            const double yi = s[0] * xi + z1;
+            z1 = s[1] * xi - s[4] * yi + z2;
+            z2 = s[2] * xi - s[5] * yi;
+            xi = yi;
+        }
+        y[(std::ptrdiff_t)k * ts] = xi;
+    }
+    for (size_t j = 0; j < zc.size(); ++j) z[j * C] = zc[j];
+}
+
+static void ba_single(const double* b, const double* a, int order,
+                      const double* x, double* y, size_t n, std::ptrdiff_t ts,
+                      double* z, size_t C) {
+    std::vector<double> zc((size_t)order);
+    for (size_t j = 0; j < zc.size(); ++j) zc[j] = z[j * C];
+    for (size_t k = 0; k < n; ++k) {
+        const double xi = x[(std::ptrdiff_t)k * ts];
+        const double yi = b[0] * xi + zc[0];
+        for (int i = 0; i < order - 1; ++i)
+            zc[i] = zc[i + 1] + b[i + 1] * xi - a[i + 1] * yi;
+        zc[order - 1] = b[order] * xi - a[order] * yi;
+        y[(std::ptrdiff_t)k * ts] = yi;
+    }
+    for (size_t j = 0; j < zc.size(); ++j) z[j * C] = zc[j];
+}
+
+// ---- from_params 设计缓存 ----
+struct DesignKey {
+    int order;
+    double fs;
+    std::string btype;
+    std::vector<double> cutoff;
+
+    bool operator==(const DesignKey& o) const {
+        return order == o.order && fs == o.fs && btype == o.btype && cutoff == o.cutoff;
+    }
+};
+
+struct DesignKeyHash {
+    size_t operator()(const DesignKey& k) const {
+        size_t h = std::hash<int>()(k.order);
+        auto mix = [&h](size_t v) { h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2); };
+        mix(std::hash<double>()(k.fs));
+        mix(std::hash<std::string>()(k.btype));
+        for (double c : k.cutoff) mix(std::hash<double>()(c));
+        return h;
+    }
+};
+
+// 最近使用的在 lru 头部; 缓存的滤波器共享同一份只读内核, 拷贝出去只增加引用计数
+struct DesignCache {
+    std::mutex mutex;
+    size_t capacity = 64;
+    size_t hits = 0;
+    size_t misses = 0;
+    std::list<std::pair<DesignKey, ButterworthFilter>> lru;
+    std::unordered_map<DesignKey, std::list<std::pair<DesignKey, ButterworthFilter>>::iterator,
+                       DesignKeyHash> index;
+};
+
+static DesignCache& design_cache() {
+    static DesignCache cache;
+    return cache;
+}
+
 } // namespace
 
 // ---------------- factory methods ----------------
@@ -72,15 +531,22 @@ ButterworthFilter ButterworthFilter::from_ba(const std::vector<double>& b,
     filter.mode_ = Mode::BA;
     filter.precompute_ = cache_zi;
     
-    filter.ba_kernel_.b = b;
-    filter.ba_kernel_.a = a;
-    normalize_ba(filter.ba_kernel_.b, filter.ba_kernel_.a);
-    filter.ba_kernel_.ntaps = (int)std::max(filter.ba_kernel_.b.size(), filter.ba_kernel_.a.size());
+    auto k = std::make_shared<BAKernel>();
+    k->b = b;
+    k->a = a;
+    normalize_ba(k->b, k->a);
+    k->ntaps = (int)std::max(k->b.size(), k->a.size());
+    // 补零到等长, 滤波时可直接交给 lfilter_df2t_raw
+    k->b.resize(k->ntaps, 0.0);
+    k->a.resize(k->ntaps, 0.0);
+    k->b32.assign(k->b.begin(), k->b.end());
+    k->a32.assign(k->a.begin(), k->a.end());
     
     if (cache_zi) {
-        filter.ba_kernel_.zi = lfilter_zi(filter.ba_kernel_.b, filter.ba_kernel_.a);
+        k->zi = lfilter_zi(k->b, k->a);
     }
     
+    filter.ba_kernel_ = std::move(k);
     return filter;
 }
 
@@ -90,15 +556,28 @@ ButterworthFilter ButterworthFilter::from_sos(const std::vector<SOSSection>& sos
     filter.mode_ = Mode::SOS;
     filter.precompute_ = cache_zi;
     
-    filter.sos_kernel_.sos = sos;
-    normalize_sos(filter.sos_kernel_.sos);
-    filter.sos_kernel_.n_sections = (int)filter.sos_kernel_.sos.size();
-    filter.sos_kernel_.ntaps = sos_ntaps(filter.sos_kernel_.sos);
+    auto k = std::make_shared<SOSKernel>();
+    k->sos = sos;
+    normalize_sos(k->sos);
+    k->n_sections = (int)k->sos.size();
+    k->ntaps = sos_ntaps(k->sos);
+    for (const auto& sec : k->sos) {
+        // z^2 + a1 z + a2 的两个根
+        const double a1 = sec[4], a2 = sec[5];
+        const double disc = a1 * a1 - 4.0 * a2;
+        const double r = disc < 0.0 ? std::sqrt(std::fabs(a2))
+                                    : 0.5 * (std::fabs(a1) + std::sqrt(disc));
+        k->pole_radius = std::max(k->pole_radius, r);
+        SOSSectionF f;
+        for (size_t i = 0; i < 6; ++i) f[i] = (float)sec[i];
+        k->sos32.push_back(f);
+    }
     
     if (cache_zi) {
-        filter.sos_kernel_.zi = sosfilt_zi(filter.sos_kernel_.sos);
+        k->zi = sosfilt_zi(k->sos);
     }
     
+    filter.sos_kernel_ = std::move(k);
     return filter;
 }
 
@@ -107,8 +586,61 @@ ButterworthFilter ButterworthFilter::from_params(int order,
                                                  const std::string& btype,
                                                  const std::vector<double>& cutoff,
                                                  bool cache_zi) {
-    auto [b, a] = butter_ba(order, fs, btype, cutoff);
-    return from_ba(b, a, cache_zi);
+    DesignCache& cache = design_cache();
+    DesignKey key{order, fs, btype, cutoff};
+    bool enabled;
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        enabled = cache.capacity > 0;
+        if (enabled) {
+            auto it = cache.index.find(key);
+            if (it != cache.index.end()) {
+                ++cache.hits;
+                cache.lru.splice(cache.lru.begin(), cache.lru, it->second);
+                return it->second->second;
+            }
+            ++cache.misses;
+        }
+    }
+
+    // 在锁外设计, 不阻塞其它线程的命中; 缓存的设计总带着 zi, 命中时省掉线性方程求解
+    ButterworthFilter filter = from_sos(butter_sos(order, fs, btype, cutoff), cache_zi || enabled);
+    if (!enabled) return filter;
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (cache.capacity == 0 || cache.index.count(key)) return filter;   // 期间被关掉或别的线程已插入
+    cache.lru.emplace_front(key, filter);
+    cache.index.emplace(std::move(key), cache.lru.begin());
+    while (cache.lru.size() > cache.capacity) {
+        cache.index.erase(cache.lru.back().first);
+        cache.lru.pop_back();
+    }
+    return filter;
+}
+
+ButterworthFilter::DesignCacheStats ButterworthFilter::design_cache_stats() {
+    DesignCache& cache = design_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return {cache.hits, cache.misses, cache.lru.size(), cache.capacity};
+}
+
+void ButterworthFilter::set_design_cache_capacity(size_t capacity) {
+    DesignCache& cache = design_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.capacity = capacity;
+    while (cache.lru.size() > cache.capacity) {
+        cache.index.erase(cache.lru.back().first);
+        cache.lru.pop_back();
+    }
+}
+
+void ButterworthFilter::clear_design_cache() {
+    DesignCache& cache = design_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.lru.clear();
+    cache.index.clear();
+    cache.hits = 0;
+    cache.misses = 0;
 }
 
 // ---------------- public APIs ----------------
@@ -121,8 +653,74 @@ std::vector<double> ButterworthFilter::filtfilt(const std::vector<double>& x,
 
 std::vector<double> ButterworthFilter::filtfilt(const double* x, size_t n,
                                                 PadType padtype, int padlen) const {
-    if (mode_ == Mode::SOS) return filtfilt_impl(sos_kernel_, x, n, padtype, padlen);
-    return filtfilt_impl(ba_kernel_, x, n, padtype, padlen);
+    Workspace ws;
+    std::vector<double> y(n);
+    filtfilt(x, n, y.data(), ws, padtype, padlen);
+    return y;
+}
+
+ButterworthFilter::Workspace ButterworthFilter::workspace(size_t max_len) const {
+    const int ntaps = mode_ == Mode::SOS ? sos_kernel_->ntaps : ba_kernel_->ntaps;
+    Workspace ws;
+    ws.ext_.resize(max_len + (size_t)6 * (size_t)ntaps);
+    ws.z_.resize(state_size());
+    const std::vector<double>& cached = mode_ == Mode::SOS ? sos_kernel_->zi : ba_kernel_->zi;
+    if (cached.empty()) ws.zi_.resize(state_size());
+    return ws;
+}
+
+void ButterworthFilter::filtfilt(const double* x, size_t n, double* y, Workspace& ws,
+                                 PadType padtype, int padlen) const {
+    const std::vector<double>& cached = mode_ == Mode::SOS ? sos_kernel_->zi : ba_kernel_->zi;
+    const double* zi = cached.data();
+    if (cached.empty() && state_size() > 0) {
+        ws.zi_.resize(state_size());
+        steady_zi_into(ws.zi_.data());
+        zi = ws.zi_.data();
+    }
+    filtfilt_impl<double, double>(x, n, y, padtype, padlen, zi, ws);
+}
+
+std::vector<float> ButterworthFilter::filtfilt(const float* x, size_t n,
+                                               PadType padtype, int padlen,
+                                               bool coeff_double) const {
+    Workspace ws;
+    std::vector<float> y(n);
+    filtfilt(x, n, y.data(), ws, padtype, padlen, coeff_double);
+    return y;
+}
+
+void ButterworthFilter::filtfilt(const float* x, size_t n, float* y, Workspace& ws,
+                                 PadType padtype, int padlen, bool coeff_double) const {
+    const std::vector<double>& cached = mode_ == Mode::SOS ? sos_kernel_->zi : ba_kernel_->zi;
+    const double* zi = cached.data();
+    if (cached.empty() && state_size() > 0) {
+        ws.zi_.resize(state_size());
+        steady_zi_into(ws.zi_.data());
+        zi = ws.zi_.data();
+    }
+    if (coeff_double) filtfilt_impl<float, double>(x, n, y, padtype, padlen, zi, ws);
+    else filtfilt_impl<float, float>(x, n, y, padtype, padlen, zi, ws);
+}
+
+std::pair<std::vector<float>, std::vector<float>>
+ButterworthFilter::lfilter(const float* x, size_t n,
+                           const std::vector<float>* zi, bool coeff_double) const {
+    std::vector<float> z(state_size(), 0.0f);
+    if (zi) {
+        if (zi->size() != z.size())
+            throw std::invalid_argument(mode_ == Mode::SOS ? "sosfilt: zi size mismatch" : "lfilter: zi size mismatch");
+        z = *zi;
+    }
+    std::vector<float> y(n);
+    if (coeff_double) {
+        std::vector<double> zd(z.begin(), z.end());
+        filter_raw(x, y.data(), n, 1, zd.data());
+        std::copy(zd.begin(), zd.end(), z.begin());
+    } else {
+        filter_raw(x, y.data(), n, 1, z.data());
+    }
+    return {y, z};
 }
 
 std::pair<std::vector<double>, std::vector<double>>
@@ -134,8 +732,8 @@ ButterworthFilter::lfilter(const std::vector<double>& x,
 std::pair<std::vector<double>, std::vector<double>>
 ButterworthFilter::lfilter(const double* x, size_t n,
                            const std::vector<double>* zi) const {
-    if (mode_ == Mode::SOS) return lfilter_impl(sos_kernel_, x, n, zi);
-    return lfilter_impl(ba_kernel_, x, n, zi);
+    if (mode_ == Mode::SOS) return lfilter_impl(*sos_kernel_, x, n, zi);
+    return lfilter_impl(*ba_kernel_, x, n, zi);
 }
 
 std::vector<double> ButterworthFilter::detrend(const std::vector<double>& x) const {
@@ -143,29 +741,766 @@ std::vector<double> ButterworthFilter::detrend(const std::vector<double>& x) con
 }
 
 std::vector<double> ButterworthFilter::detrend(const double* x, size_t n) const {
-    if (n <= 1) return std::vector<double>(x, x + n);
+    return ::detrend(x, n, DetrendType::Linear);
+}
+
+// ---------------- multi-channel ----------------
+
+size_t ButterworthFilter::state_size() const {
+    if (mode_ == Mode::SOS) return (size_t)2 * sos_kernel_->sos.size();
+    const size_t ntaps = std::max(ba_kernel_->b.size(), ba_kernel_->a.size());
+    return ntaps > 0 ? ntaps - 1 : 0;
+}
+
+void ButterworthFilter::steady_zi_into(double* zi) const {
+    if (mode_ == Mode::SOS) sosfilt_zi_into(sos_kernel_->sos.data(), (int)sos_kernel_->sos.size(), zi);
+    else if (state_size() > 0) lfilter_zi_into(ba_kernel_->b.data(), ba_kernel_->a.data(), (int)state_size(), zi);
+}
+
+std::vector<double> ButterworthFilter::steady_zi() const {
+    if (mode_ == Mode::SOS) return sos_kernel_->zi.empty() ? sosfilt_zi(sos_kernel_->sos) : sos_kernel_->zi;
+    if (state_size() == 0) return {};
+    return ba_kernel_->zi.empty() ? lfilter_zi(ba_kernel_->b, ba_kernel_->a) : ba_kernel_->zi;
+}
+
+void ButterworthFilter::filter_lanes(const double* x, double* y, size_t n, std::ptrdiff_t ts, std::ptrdiff_t cs,
+                                     size_t C, double* z) const {
+    if (mode_ == Mode::SOS) {
+        const SOSSection* sos = sos_kernel_->sos.data();
+        const int nsec = (int)sos_kernel_->sos.size();
+        for (size_t c0 = 0; c0 < C; c0 += kSosLanes) {
+            const size_t w = std::min(kSosLanes, C - c0);
+            const std::ptrdiff_t off = (std::ptrdiff_t)c0 * cs;
+            if (w == 1)
+                sos_single(sos, nsec, x + off, y + off, n, ts, z + c0, C);
+            else
+                sos_lanes(sos, nsec, x + off, y + off, n, ts, cs, z + c0, C, w);
+        }
+        return;
+    }
+
+    const int order = (int)state_size();
+    if (order == 0) {
+        const double g = ba_kernel_->b.empty() ? 0.0 : ba_kernel_->b[0];
+        for (size_t k = 0; k < n; ++k)
+            for (size_t c = 0; c < C; ++c) {
+                const std::ptrdiff_t i = (std::ptrdiff_t)k * ts + (std::ptrdiff_t)c * cs;
+                y[i] = g * x[i];
+            }
+        return;
+    }
+    const std::vector<double> b = pad_to_len(ba_kernel_->b, order + 1);
+    const std::vector<double> a = pad_to_len(ba_kernel_->a, order + 1);
+    for (size_t c0 = 0; c0 < C; c0 += kBaLanes) {
+        const size_t w = std::min(kBaLanes, C - c0);
+        const std::ptrdiff_t off = (std::ptrdiff_t)c0 * cs;
+        if (w == 1)
+            ba_single(b.data(), a.data(), order, x + off, y + off, n, ts, z + c0, C);
+        else
+            ba_lanes(b.data(), a.data(), order, x + off, y + off, n, ts, cs, z + c0, C, w);
+    }
+}
+
+// 把 (rows, cols) 的 x 按 axis 拆成时间长度 n 与通道数 C
+static void split_axis(size_t rows, size_t cols, int axis, size_t& n, size_t& C) {
+    if (axis == 0) { n = rows; C = cols; return; }
+    if (axis == 1 || axis == -1) { n = cols; C = rows; return; }
+    throw std::invalid_argument("axis must be 0, 1 or -1 for 2D input");
+}
+
+std::vector<double> ButterworthFilter::lfilter_multi(const double* x, size_t rows, size_t cols, int axis,
+                                                     const std::vector<double>* zi,
+                                                     std::vector<double>* zf) const {
+    size_t n = 0, C = 0;
+    split_axis(rows, cols, axis, n, C);
+    const size_t ns = state_size();
+
+    // 状态转成 lane 布局 z[j * C + c]
+    std::vector<double> z(ns * C, 0.0);
+    if (zi) {
+        if (zi->size() != ns * C) throw std::invalid_argument("lfilter: zi size mismatch, expected (channels, state_size)");
+        for (size_t c = 0; c < C; ++c)
+            for (size_t j = 0; j < ns; ++j) z[j * C + c] = (*zi)[c * ns + j];
+    }
+
+    // 每行一个通道时按块在 L1 里转置 (见 load_tile), 不整体转成时间主序
+    std::vector<double> y(rows * cols);
+    const std::ptrdiff_t ts = axis == 0 ? (std::ptrdiff_t)C : 1;
+    const std::ptrdiff_t cs = axis == 0 ? 1 : (std::ptrdiff_t)n;
+    filter_lanes(x, y.data(), n, ts, cs, C, z.data());
+
+    if (zf) {
+        zf->resize(ns * C);
+        for (size_t c = 0; c < C; ++c)
+            for (size_t j = 0; j < ns; ++j) (*zf)[c * ns + j] = z[j * C + c];
+    }
+    return y;
+}
+
+std::vector<double> ButterworthFilter::filtfilt_multi(const double* x, size_t rows, size_t cols, int axis,
+                                                      PadType padtype, int padlen) const {
+    size_t n = 0, C = 0;
+    split_axis(rows, cols, axis, n, C);
+    if (n == 0 || C == 0) return std::vector<double>(rows * cols);
+    if (mode_ == Mode::SOS ? sos_kernel_->sos.empty() : (ba_kernel_->b.empty() || ba_kernel_->a.empty()))
+        throw std::invalid_argument("filtfilt: empty filter");
+
+    const int ntaps = mode_ == Mode::SOS ? sos_kernel_->ntaps : ba_kernel_->ntaps;
+    const size_t edge = (size_t)compute_edge((int)n, ntaps, padtype, padlen);
+    const size_t len = n + 2 * edge;
+
+    // 中间段直接滤进输出 y (与 x 同布局), 两侧延拓段各放进一小块时间主序的 (edge, C) 缓冲区;
+    // 状态在三段之间接力, 不必拼出整个延拓信号, 也不必转置
+    const std::ptrdiff_t ts = axis == 0 ? (std::ptrdiff_t)C : 1;
+    const std::ptrdiff_t cs = axis == 0 ? 1 : (std::ptrdiff_t)n;
+    auto at = [&](size_t k, size_t c) { return x[(std::ptrdiff_t)k * ts + (std::ptrdiff_t)c * cs]; };
+    std::vector<double> left(edge * C), right(edge * C);
+    for (size_t i = 0; i < edge; ++i) {
+        // 左侧镜像 x[edge], ..., x[1], 右侧镜像 x[n-2], ..., x[n-1-edge]
+        double* l = left.data() + i * C;
+        double* r = right.data() + i * C;
+        for (size_t c = 0; c < C; ++c) {
+            const double x0 = at(0, c), x1 = at(n - 1, c);
+            if (padtype == PadType::Odd) {
+                l[c] = 2.0 * x0 - at(edge - i, c);
+                r[c] = 2.0 * x1 - at(n - 2 - i, c);
+            } else if (padtype == PadType::Even) {
+                l[c] = at(edge - i, c);
+                r[c] = at(n - 2 - i, c);
+            } else {
+                l[c] = x0;
+                r[c] = x1;
+            }
+        }
+    }
+
+    const std::vector<double> zi = steady_zi();
+    const size_t ns = zi.size();
+    std::vector<double> z(ns * C);
+    std::vector<double> y(rows * cols);
+    const std::ptrdiff_t tc = (std::ptrdiff_t)C;
+
+    // 正向: z = zi * (延拓信号第一个样本)
+    for (size_t j = 0; j < ns; ++j)
+        for (size_t c = 0; c < C; ++c) z[j * C + c] = zi[j] * (edge ? left[c] : at(0, c));
+    if (edge) filter_lanes(left.data(), left.data(), edge, tc, 1, C, z.data());
+    filter_lanes(x, y.data(), n, ts, cs, C, z.data());
+    if (edge) filter_lanes(right.data(), right.data(), edge, tc, 1, C, z.data());
+
+    // 反向: 负步长原地处理, 无需 reverse; z = zi * (正向输出最后一个样本).
+    // 左侧延拓段的反向输出用不到, 不算
+    double* y_last = y.data() + (std::ptrdiff_t)(n - 1) * ts;
+    double* r_last = right.data() + (edge ? edge - 1 : 0) * C;
+    for (size_t j = 0; j < ns; ++j)
+        for (size_t c = 0; c < C; ++c) z[j * C + c] = zi[j] * (edge ? r_last[c] : y_last[(std::ptrdiff_t)c * cs]);
+    if (edge) filter_lanes(r_last, r_last, edge, -tc, 1, C, z.data());
+    filter_lanes(y_last, y_last, n, -ts, cs, C, z.data());
+    return y;
+}
+
+// ---------------- batch ----------------
+
+void ButterworthFilter::filtfilt_batch(const double* const* xs, const size_t* lens, size_t count,
+                                       double* const* ys,
+                                       PadType padtype, int padlen, int num_threads) const {
+    if (count == 0) return;
+    if (mode_ == Mode::SOS ? sos_kernel_->sos.empty() : (ba_kernel_->b.empty() || ba_kernel_->a.empty()))
+        throw std::invalid_argument("filtfilt: empty filter");
+
+    const size_t workers = std::min(thread_count(num_threads), count);
+
+    const std::vector<double> zi = steady_zi();
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    // 每个工作线程一个自己的 Workspace, 按需增长后在线程内复用
+    auto worker = [&]() {
+        Workspace ws;
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            try {
+                filtfilt_impl<double, double>(xs[i], lens[i], ys[i], padtype, padlen, zi.data(), ws);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+                next.store(count);
+            }
+        }
+    };
+
+    run_workers(workers, [&](size_t) { worker(); });
+    if (error) std::rethrow_exception(error);
+}
+
+void ButterworthFilter::filtfilt_batch(const double* x, const size_t* offsets, size_t count,
+                                       double* y,
+                                       PadType padtype, int padlen, int num_threads) const {
+    std::vector<const double*> xs(count);
+    std::vector<double*> ys(count);
+    std::vector<size_t> lens(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (offsets[i + 1] < offsets[i]) throw std::invalid_argument("filtfilt_batch: offsets must be non-decreasing");
+        xs[i] = x + offsets[i];
+        ys[i] = y + offsets[i];
+        lens[i] = offsets[i + 1] - offsets[i];
+    }
+    filtfilt_batch(xs.data(), lens.data(), count, ys.data(), padtype, padlen, num_threads);
+}
+
+// ---------------- time-parallel ----------------
+
+template <class T, class C>
+void ButterworthFilter::filter_raw(const T* x, T* y, size_t n, std::ptrdiff_t stride, C* z) const {
+    constexpr bool narrow = std::is_same<C, float>::value;
+    if (mode_ == Mode::SOS) {
+        if (sos_kernel_->sos.empty()) {
+            for (size_t k = 0; k < n; ++k, x += stride, y += stride) *y = *x;
+            return;
+        }
+        if constexpr (narrow) sosfilt_df2t_raw(sos_kernel_->sos32.data(), sos_kernel_->n_sections, x, y, n, z, stride);
+        else sosfilt_df2t_raw(sos_kernel_->sos.data(), sos_kernel_->n_sections, x, y, n, z, stride);
+        return;
+    }
+    const size_t ns = state_size();
+    if (ns > 0) {
+        if constexpr (narrow) lfilter_df2t_raw(ba_kernel_->b32.data(), ba_kernel_->a32.data(), (int)ns, x, y, n, z, stride);
+        else lfilter_df2t_raw(ba_kernel_->b.data(), ba_kernel_->a.data(), (int)ns, x, y, n, z, stride);
+        return;
+    }
+    const double g = ba_kernel_->b.empty() ? 0.0 : ba_kernel_->b[0];
+    for (size_t k = 0; k < n; ++k, x += stride, y += stride) *y = (T)(g * *x);
+}
+
+void ButterworthFilter::filter_pass(const double* x, double* y, size_t n, std::ptrdiff_t stride,
+                                    double* z, size_t workers) const {
+    const size_t ns = state_size();
+    workers = std::min(workers, n / kMinParallelChunk);
+    if (workers <= 1 || ns == 0) {
+        filter_raw(x, y, n, stride, z);
+        return;
+    }
+
+    // 块 j 覆盖 [j * L, min((j + 1) * L, n)), 最后一块长 last
+    const size_t L = (n + workers - 1) / workers;
+    const size_t last = n - (workers - 1) * L;
+    auto at = [stride](auto* p, size_t k) { return p + (std::ptrdiff_t)k * stride; };
+
+    // 1) 并行: 块 0 从真实状态 z 出发, 其余从零状态出发; e[j] 为各块的末状态
+    std::vector<double> e(workers * ns, 0.0);
+    std::copy(z, z + ns, e.begin());
+    run_workers(workers, [&](size_t j) {
+        const size_t m = j + 1 < workers ? L : last;
+        filter_raw(at(x, j * L), at(y, j * L), m, stride, e.data() + j * ns);
+    });
+
+    // 2) 顺序: s[j + 1] = A^L s[j] + e[j], A 为一步零输入的状态转移矩阵 (逐列对单位状态走一步得到)
+    std::vector<double> A(ns * ns), col(ns);
+    const double zero = 0.0;
+    double out;
+    for (size_t i = 0; i < ns; ++i) {
+        std::fill(col.begin(), col.end(), 0.0);
+        col[i] = 1.0;
+        filter_raw(&zero, &out, 1, 1, col.data());
+        for (size_t r = 0; r < ns; ++r) A[r * ns + i] = col[r];
+    }
+    const std::vector<double> AL = mat_pow(A, L, ns);
+    const std::vector<double> Alast = mat_pow(A, last, ns);
+    std::vector<double> s(workers * ns, 0.0);   // s[0] 无需修正, 留作零
+    auto advance = [ns](const std::vector<double>& P, const double* sj, const double* ej, double* dst) {
+        for (size_t r = 0; r < ns; ++r) {
+            double acc = ej[r];
+            for (size_t c = 0; c < ns; ++c) acc += P[r * ns + c] * sj[c];
+            dst[r] = acc;
+        }
+    };
+    std::copy(e.begin(), e.begin() + ns, s.begin() + ns);
+    for (size_t j = 1; j + 1 < workers; ++j)
+        advance(AL, s.data() + j * ns, e.data() + j * ns, s.data() + (j + 1) * ns);
+    advance(Alast, s.data() + (workers - 1) * ns, e.data() + (workers - 1) * ns, z);
+
+    // 3) 并行: 块 j 开头加上 s[j] 的零输入响应, 状态衰减到 kTransientTol 以下即停
+    run_workers(workers - 1, [&](size_t t) {
+        const size_t j = t + 1;
+        const size_t m = j + 1 < workers ? L : last;
+        double* st = s.data() + j * ns;
+        double ref = 0.0;
+        for (size_t r = 0; r < ns; ++r) ref = std::max(ref, std::fabs(st[r]));
+        if (ref == 0.0) return;
+
+        const double zeros[kFixBlock] = {};
+        double resp[kFixBlock];
+        for (size_t k = 0; k < m; k += kFixBlock) {
+            const size_t b = std::min(kFixBlock, m - k);
+            filter_raw(zeros, resp, b, 1, st);
+            double* yk = at(y, j * L + k);
+            for (size_t i = 0; i < b; ++i) yk[(std::ptrdiff_t)i * stride] += resp[i];
+
+            double mag = 0.0;
+            for (size_t r = 0; r < ns; ++r) mag = std::max(mag, std::fabs(st[r]));
+            if (mag <= kTransientTol * ref) break;
+        }
+    });
+}
+
+std::pair<std::vector<double>, std::vector<double>>
+ButterworthFilter::lfilter_parallel(const double* x, size_t n,
+                                    const std::vector<double>* zi, int num_threads) const {
+    std::vector<double> z(state_size(), 0.0);
+    if (zi) {
+        if (zi->size() != z.size())
+            throw std::invalid_argument(mode_ == Mode::SOS ? "sosfilt: zi size mismatch" : "lfilter: zi size mismatch");
+        z = *zi;
+    }
+    std::vector<double> y(n);
+    filter_pass(x, y.data(), n, 1, z.data(), thread_count(num_threads));
+    return {y, z};
+}
+
+std::vector<double> ButterworthFilter::filtfilt_parallel(const double* x, size_t n,
+                                                         PadType padtype, int padlen,
+                                                         int num_threads) const {
+    const std::vector<double> zi = steady_zi();
+    Workspace ws;
+    std::vector<double> y(n);
+    filtfilt_impl<double, double>(x, n, y.data(), padtype, padlen, zi.data(), ws, thread_count(num_threads));
+    return y;
+}
+
+// ---------------- FFT zero-phase backend ----------------
+
+const std::vector<double>& ButterworthFilter::impulse_response() const {
+    if (mode_ == Mode::SOS) {
+        std::call_once(sos_kernel_->ir_once, [this] { sos_kernel_->ir = compute_impulse_response(); });
+        return sos_kernel_->ir;
+    }
+    std::call_once(ba_kernel_->ir_once, [this] { ba_kernel_->ir = compute_impulse_response(); });
+    return ba_kernel_->ir;
+}
+
+size_t ButterworthFilter::impulse_length_estimate() const {
+    if (mode_ == Mode::BA) {
+        const size_t M = impulse_response().size();
+        return M > 0 ? M : std::numeric_limits<size_t>::max();
+    }
+    // 尾部按 r^k 衰减, 降到 kImpulseTol 需要 ln(tol) / ln(r) 个样本 (重极点的多项式因子忽略, 只用来估耗时)
+    const double r = sos_kernel_->pole_radius;
+    if (!(r < 1.0)) return std::numeric_limits<size_t>::max();
+    if (r <= 0.0) return 1;
+    const double len = std::log(kImpulseTol) / std::log(r);
+    return len >= (double)kMaxImpulseLen ? std::numeric_limits<size_t>::max() : (size_t)len + 1;
+}
+
+std::vector<double> ButterworthFilter::compute_impulse_response() const {
+    constexpr size_t kBlock = 1024;
+    std::vector<double> z(state_size(), 0.0);
+    std::vector<double> h;
+    double x[kBlock] = {1.0};
+    double peak = 0.0;
+    for (size_t pos = 0; pos < kMaxImpulseLen; pos += kBlock) {
+        h.resize(pos + kBlock);
+        filter_raw(x, h.data() + pos, kBlock, 1, z.data());
+        x[0] = 0.0;
+        for (size_t i = pos; i < pos + kBlock; ++i) peak = std::max(peak, std::fabs(h[i]));
+
+        // 剩余状态足够小, 之后的零输入响应可以忽略
+        double mag = 0.0;
+        for (double v : z) mag = std::max(mag, std::fabs(v));
+        if (mag <= kImpulseTol * peak) {
+            while (h.size() > 1 && std::fabs(h.back()) <= kImpulseTol * peak) h.pop_back();
+            return h;
+        }
+    }
+    return {};
+}
 
-    // y = x - (m*t + c), t = 0..n-1
-    const double N = (double)n;
-    const double sum_t  = (N - 1.0) * N * 0.5;
-    const double sum_tt = (N - 1.0) * N * (2.0 * N - 1.0) / 6.0;
+void ButterworthFilter::filtfilt_fft(const double* x, size_t n, double* y,
+                                     PadType padtype, int padlen,
+                                     const std::vector<double>& h, size_t workers) const {
+    const int ntaps = mode_ == Mode::SOS ? sos_kernel_->ntaps : ba_kernel_->ntaps;
+    const size_t edge = (size_t)compute_edge((int)n, ntaps, padtype, padlen);
+    const size_t len = n + 2 * edge;
+    std::vector<double> ext(len);
+    pad_extend_into(x, n, (int)edge, padtype, ext.data());
+
+    // |H|^2 的卷积核 (h 的自相关) 在 [-(M-1), M-1] 上, 每块 N 点的循环卷积中前后各 M-1 点无效
+    const size_t M = h.size();
+    const size_t N = fft_block_len(n, M);
+    const size_t L = N - 2 * (M - 1);
+    const FftPlan plan(N);
+
+    // N >= 2M-1 时循环自相关等于线性自相关, |FFT_N(h)|^2 就是卷积核的频谱; 逆变换的 1/N 一并乘上
+    std::vector<double> gain(N);
+    {
+        std::vector<std::complex<double>> spec(N);
+        std::copy(h.begin(), h.end(), spec.begin());
+        plan.run(spec.data(), false);
+        for (size_t k = 0; k < N; ++k) gain[k] = std::norm(spec[k]) / (double)N;
+    }
+
+    // 延拓段之外按端点值保持
+    auto at = [&](std::ptrdiff_t i) {
+        if (i < 0) return ext[0];
+        if ((size_t)i >= len) return ext[len - 1];
+        return ext[(size_t)i];
+    };
+
+    // 卷积核是实对称的, 两块实信号分别放进实部和虚部, 一次复数 FFT 处理两块
+    const size_t blocks = (n + L - 1) / L;
+    const size_t pairs = (blocks + 1) / 2;
+    workers = std::max<size_t>(1, std::min(workers, pairs));
+    run_workers(workers, [&](size_t t) {
+        std::vector<std::complex<double>> buf(N);
+        for (size_t p = t; p < pairs; p += workers) {
+            const size_t b0 = 2 * p;
+            const bool two = b0 + 1 < blocks;
+            // 第 b 块输出 y[b*L, b*L+L), 对应的输入窗口从 ext[edge + b*L - (M-1)] 开始
+            const std::ptrdiff_t s0 = (std::ptrdiff_t)(edge + b0 * L) - (std::ptrdiff_t)(M - 1);
+            const std::ptrdiff_t s1 = s0 + (std::ptrdiff_t)L;
+            for (size_t i = 0; i < N; ++i)
+                buf[i] = {at(s0 + (std::ptrdiff_t)i), two ? at(s1 + (std::ptrdiff_t)i) : 0.0};
+            plan.run(buf.data(), false);
+            for (size_t k = 0; k < N; ++k) buf[k] *= gain[k];
+            plan.run(buf.data(), true);
+
+            const size_t k0 = b0 * L;
+            const size_t m0 = std::min(L, n - k0);
+            for (size_t j = 0; j < m0; ++j) y[k0 + j] = buf[M - 1 + j].real();
+            if (two) {
+                const size_t m1 = std::min(L, n - k0 - L);
+                for (size_t j = 0; j < m1; ++j) y[k0 + L + j] = buf[M - 1 + j].imag();
+            }
+        }
+    });
+
+    // 右端: IIR 反向初值是 zi * (正向输出末值), 与 "输入在末端保持" 不同, 差异是反向滤波的零输入响应,
+    // 向左经过 M 个样本衰减到可忽略. 末尾 T = M 点重新精确计算: 正向输出由 h 的卷积得到 (同样一次 FFT),
+    // 再从真正的初值做反向递推
+    const size_t T = std::min(M, len);
+    if (len - T >= edge + n) return;
+    const size_t Nt = next_pow2(T + M - 1);
+    const FftPlan tail_plan(Nt);
+    std::vector<std::complex<double>> hs(Nt), u(Nt);
+    std::copy(h.begin(), h.end(), hs.begin());
+    tail_plan.run(hs.data(), false);
+    const std::ptrdiff_t base = (std::ptrdiff_t)(len - T) - (std::ptrdiff_t)(M - 1);
+    for (size_t i = 0; i < T + M - 1; ++i) u[i] = at(base + (std::ptrdiff_t)i);
+    tail_plan.run(u.data(), false);
+    for (size_t k = 0; k < Nt; ++k) u[k] *= hs[k] / (double)Nt;
+    tail_plan.run(u.data(), true);
+
+    std::vector<double> tail(T);
+    for (size_t j = 0; j < T; ++j) tail[j] = u[M - 1 + j].real();
+    const std::vector<double>& cached = mode_ == Mode::SOS ? sos_kernel_->zi : ba_kernel_->zi;
+    const std::vector<double> zi = cached.empty() ? steady_zi() : cached;
+    std::vector<double> z(state_size());
+    for (size_t i = 0; i < z.size(); ++i) z[i] = zi[i] * tail[T - 1];
+    filter_raw(tail.data() + T - 1, tail.data() + T - 1, T, -1, z.data());
+
+    for (size_t p = std::max(len - T, edge); p < edge + n; ++p) y[p - edge] = tail[p - (len - T)];
+}
 
-    double sum_y = 0.0, sum_ty = 0.0;
-    for (size_t i = 0; i < n; ++i) {
-        sum_y  += x[i];
-        sum_ty += (double)i * x[i];
+std::vector<double> ButterworthFilter::filtfilt(const double* x, size_t n,
+                                                PadType padtype, int padlen,
+                                                FiltfiltBackend backend,
+                                                int num_threads) const {
+    if (backend == FiltfiltBackend::IIR || n == 0) {
+        return num_threads == 1 ? filtfilt(x, n, padtype, padlen)
+                                : filtfilt_parallel(x, n, padtype, padlen, num_threads);
+    }
+    if (mode_ == Mode::SOS) {
+        if (sos_kernel_->sos.empty()) throw std::invalid_argument("filtfilt: sos empty");
+    } else if (ba_kernel_->b.empty() || ba_kernel_->a.empty()) {
+        throw std::invalid_argument("filtfilt: b/a empty");
     }
 
-    const double denom = N * sum_tt - sum_t * sum_t;
-    double m = 0.0;
-    if (denom != 0.0) m = (N * sum_ty - sum_t * sum_y) / denom;
-    const double c = (sum_y / N) - m * (sum_t / N);
+    // 冲激响应缓存在内核里, 这里只取引用
+    const std::vector<double>* h = nullptr;
+    if (backend == FiltfiltBackend::FFT) {
+        h = &impulse_response();
+        if (h->empty()) throw std::invalid_argument("filtfilt: impulse response does not decay, FFT backend unavailable");
+    } else if (n >= kMinFftLen) {
+        // 即使 M = 1, FFT 每样本也至少要 kFftCost * log2(4096); IIR 比这还便宜时 (低阶设计) 不必估计冲激响应
+        const double iir_cost = (kIirCostBase + kIirCostPerState * (double)state_size()) * (double)n;
+        if (iir_cost > kFftCost * 12.0 * (double)n) {
+            const size_t M = impulse_length_estimate();
+            if (M <= kMaxImpulseLen && fft_filtfilt_cost(n, M) < iir_cost) h = &impulse_response();
+        }
+    }
+    if (!h || h->empty()) {
+        return num_threads == 1 ? filtfilt(x, n, padtype, padlen)
+                                : filtfilt_parallel(x, n, padtype, padlen, num_threads);
+    }
 
     std::vector<double> y(n);
-    for (size_t i = 0; i < n; ++i) y[i] = x[i] - (m * (double)i + c);
+    filtfilt_fft(x, n, y.data(), padtype, padlen, *h, thread_count(num_threads));
+    return y;
+}
+
+// ---------------- frequency response ----------------
+
+ButterworthFilter::FrequencyResponse
+ButterworthFilter::freqz(size_t n, bool whole, double fs) const {
+    // 同 scipy.signal.freqz(worN=n): [0, fs/2) 或 whole 时 [0, fs) 上均匀 n 点, 不含右端点
+    const double span = whole ? fs : 0.5 * fs;
+    std::vector<double> w(n);
+    for (size_t k = 0; k < n; ++k) w[k] = span * (double)k / (double)n;
+    return freqz(w.data(), n, fs);
+}
+
+ButterworthFilter::FrequencyResponse
+ButterworthFilter::freqz(const double* w, size_t n, double fs) const {
+    using L = Lanes;
+    constexpr size_t W = L::width;
+    if (!(fs > 0.0)) throw std::invalid_argument("freqz: fs must be > 0");
+
+    FrequencyResponse r;
+    r.w.assign(w, w + n);
+    r.magnitude.resize(n);
+    r.phase.resize(n);
+    r.group_delay.resize(n);
+
+    const double to_rad = 2.0 * std::acos(-1.0) / fs;
+    for (size_t k0 = 0; k0 < n; k0 += W) {
+        const size_t m = std::min(W, n - k0);
+        // z = e^{-jw}, 不足一组时多余的频点取 0 Hz, 结果丢弃
+        double zr_buf[W], zi_buf[W];
+        for (size_t l = 0; l < W; ++l) {
+            const double wr = l < m ? w[k0 + l] * to_rad : 0.0;
+            zr_buf[l] = std::cos(wr);
+            zi_buf[l] = -std::sin(wr);
+        }
+        const L::reg zr = L::load(zr_buf), zi = L::load(zi_buf);
+
+        // 分子、分母各自连乘, 群延迟逐个多项式相加
+        L::reg nr = L::set1(1.0), ni = L::set1(0.0);
+        L::reg dr = L::set1(1.0), di = L::set1(0.0);
+        L::reg gd = L::set1(0.0);
+        L::reg pr, pi, qr, qi;
+        if (mode_ == Mode::SOS) {
+            for (const SOSSection& s : sos_kernel_->sos) {
+                poly_response_lanes(s.data(), 2, zr, zi, pr, pi, qr, qi);
+                cmul_lanes(nr, ni, pr, pi);
+                gd = L::add(gd, poly_delay_lanes(pr, pi, qr, qi));
+                poly_response_lanes(s.data() + 3, 2, zr, zi, pr, pi, qr, qi);
+                cmul_lanes(dr, di, pr, pi);
+                gd = L::sub(gd, poly_delay_lanes(pr, pi, qr, qi));
+            }
+        } else {
+            const BAKernel& k = *ba_kernel_;
+            poly_response_lanes(k.b.data(), k.b.size() - 1, zr, zi, pr, pi, qr, qi);
+            nr = pr; ni = pi;
+            gd = poly_delay_lanes(pr, pi, qr, qi);
+            poly_response_lanes(k.a.data(), k.a.size() - 1, zr, zi, pr, pi, qr, qi);
+            dr = pr; di = pi;
+            gd = L::sub(gd, poly_delay_lanes(pr, pi, qr, qi));
+        }
+
+        // H = N / D: 相位取 N conj(D) 的辐角, 幅值 |N| / |D|
+        double nr_buf[W], ni_buf[W], dr_buf[W], di_buf[W], gd_buf[W];
+        L::store(nr_buf, nr); L::store(ni_buf, ni);
+        L::store(dr_buf, dr); L::store(di_buf, di);
+        L::store(gd_buf, gd);
+        for (size_t l = 0; l < m; ++l) {
+            const double hr = nr_buf[l] * dr_buf[l] + ni_buf[l] * di_buf[l];
+            const double hi = ni_buf[l] * dr_buf[l] - nr_buf[l] * di_buf[l];
+            r.magnitude[k0 + l] = std::hypot(nr_buf[l], ni_buf[l]) / std::hypot(dr_buf[l], di_buf[l]);
+            r.phase[k0 + l] = std::atan2(hi, hr);
+            r.group_delay[k0 + l] = gd_buf[l];
+        }
+    }
+    return r;
+}
+
+ButterworthFilter::FrequencyResponse
+ButterworthFilter::sosfreqz(size_t n, bool whole, double fs) const {
+    if (mode_ != Mode::SOS) throw std::invalid_argument("sosfreqz: filter is in BA mode, use freqz");
+    return freqz(n, whole, fs);
+}
+
+ButterworthFilter::FrequencyResponse
+ButterworthFilter::sosfreqz(const double* w, size_t n, double fs) const {
+    if (mode_ != Mode::SOS) throw std::invalid_argument("sosfreqz: filter is in BA mode, use freqz");
+    return freqz(w, n, fs);
+}
+
+// ---------------- streaming ----------------
+
+ButterworthFilter::Stream ButterworthFilter::stream() const {
+    Stream st;
+    st.mode_ = mode_;
+    if (mode_ == Mode::SOS) {
+        st.sos_ = sos_kernel_->sos;
+        st.zi_ = sos_kernel_->zi.empty() ? sosfilt_zi(st.sos_) : sos_kernel_->zi;
+        st.z_.assign(st.zi_.size(), 0.0);
+        return st;
+    }
+    st.order_ = (int)std::max(ba_kernel_->b.size(), ba_kernel_->a.size()) - 1;
+    st.b_ = pad_to_len(ba_kernel_->b, st.order_ + 1);
+    st.a_ = pad_to_len(ba_kernel_->a, st.order_ + 1);
+    if (st.order_ > 0) {
+        st.zi_ = ba_kernel_->zi.empty() ? lfilter_zi(ba_kernel_->b, ba_kernel_->a) : ba_kernel_->zi;
+    }
+    st.z_.assign(st.zi_.size(), 0.0);
+    return st;
+}
+
+void ButterworthFilter::Stream::process(const double* x, double* y, size_t n) {
+    if (mode_ == Mode::SOS) {
+        if (sos_.empty()) {
+            if (x != y) std::copy(x, x + n, y);
+            return;
+        }
+        sosfilt_df2t_raw(sos_.data(), (int)sos_.size(), x, y, n, z_.data());
+        return;
+    }
+    if (order_ <= 0) {
+        const double g = b_.empty() ? 0.0 : b_[0];
+        for (size_t k = 0; k < n; ++k) y[k] = g * x[k];
+        return;
+    }
+    lfilter_df2t_raw(b_.data(), a_.data(), order_, x, y, n, z_.data());
+}
+
+void ButterworthFilter::Stream::reset() {
+    std::fill(z_.begin(), z_.end(), 0.0);
+}
+
+void ButterworthFilter::Stream::prime(double x0) {
+    for (size_t i = 0; i < z_.size(); ++i) z_[i] = zi_[i] * x0;
+}
+
+void ButterworthFilter::Stream::set_state(const std::vector<double>& zi) {
+    if (zi.size() != z_.size()) throw std::invalid_argument("Stream: zi size mismatch");
+    std::copy(zi.begin(), zi.end(), z_.begin());
+}
+
+// ---------------- resampling ----------------
+
+ButterworthFilter ButterworthFilter::antialias(int up, int down, int order) {
+    if (up < 1 || down < 1) throw std::invalid_argument("antialias: up/down must be >= 1");
+    // fs = 2 时截止频率就是相对 Nyquist 的归一化频率
+    return from_params(order, 2.0, "lowpass", {0.8 / (double)std::max(up, down)});
+}
+
+std::vector<double> ButterworthFilter::decimate(const double* x, size_t n, int q,
+                                                bool zero_phase,
+                                                PadType padtype, int padlen) const {
+    if (q < 1) throw std::invalid_argument("decimate: q must be >= 1");
+    return resample_poly(x, n, 1, q, zero_phase, padtype, padlen);
+}
+
+std::vector<double> ButterworthFilter::resample_poly(const double* x, size_t n, int up, int down,
+                                                     bool zero_phase,
+                                                     PadType padtype, int padlen) const {
+    if (up < 1 || down < 1) throw std::invalid_argument("resample_poly: up/down must be >= 1");
+    if (!zero_phase) {
+        Resampler r = resampler(up, down);
+        std::vector<double> y(r.max_output(n));
+        y.resize(r.process(x, n, y.data()));
+        return y;
+    }
+    if (mode_ == Mode::SOS) {
+        if (sos_kernel_->sos.empty()) throw std::invalid_argument("resample_poly: sos empty");
+    } else if (ba_kernel_->b.empty() || ba_kernel_->a.empty()) {
+        throw std::invalid_argument("resample_poly: b/a empty");
+    }
+    if (n == 0) return {};
+
+    // 延拓在原采样率上做 (padlen 按输入样本计), 之后零插值到 up 倍速率
+    const int ntaps = mode_ == Mode::SOS ? sos_kernel_->ntaps : ba_kernel_->ntaps;
+    const size_t edge = (size_t)compute_edge((int)n, ntaps, padtype, padlen);
+    const size_t len = (n + 2 * edge) * (size_t)up;
+    const size_t m = (n * (size_t)up + (size_t)down - 1) / (size_t)down;
+    const size_t first = edge * (size_t)up;   // 第一个保留样本在升采样缓冲中的位置
+
+    std::vector<double> ext(len, 0.0);
+    double x0;
+    if (up == 1) {
+        pad_extend_into(x, n, (int)edge, padtype, ext.data());
+        x0 = ext[0];
+    } else {
+        std::vector<double> tmp(n + 2 * edge);
+        pad_extend_into(x, n, (int)edge, padtype, tmp.data());
+        for (size_t i = 0; i < tmp.size(); ++i) ext[i * (size_t)up] = (double)up * tmp[i];
+        x0 = tmp[0];
+    }
+
+    const std::vector<double>& cached = mode_ == Mode::SOS ? sos_kernel_->zi : ba_kernel_->zi;
+    const std::vector<double> zi = cached.empty() ? steady_zi() : cached;
+    std::vector<double> z(state_size());
+
+    // forward 初值按延拓后的原始样本 x0 取, 不是 ext[0] = up*x0: 零插值并乘 up 后低通输出的直流电平仍是 x0.
+    // up > 1 时开头的输入是周期为 up 的 [up*x0, 0, ..., 0], 稳态也是周期的, 直流稳态 zi*x0 仍差一段瞬态;
+    // 取一个周期前后不变的状态: z = Phi z + c, Phi 为零输入走 up 步的状态转移, c 为零状态走一个周期的结果
+    std::vector<double> z0 = zi;   // x0 = 1 时的初值
+    if (up > 1 && !z.empty()) {
+        const int ns = (int)z.size();
+        std::vector<double> period((size_t)up, 0.0), out((size_t)up), A((size_t)ns * ns), c(ns, 0.0), e(ns);
+        for (int j = 0; j < ns; ++j) {
+            std::fill(e.begin(), e.end(), 0.0);
+            e[j] = 1.0;
+            filter_raw(period.data(), out.data(), (size_t)up, 1, e.data());
+            for (int i = 0; i < ns; ++i) A[(size_t)i * ns + j] = (i == j ? 1.0 : 0.0) - e[i];
+        }
+        period[0] = (double)up;
+        filter_raw(period.data(), out.data(), (size_t)up, 1, c.data());
+        z0 = solve_linear(A, c, ns);
+    }
+
+    // forward, 原地
+    for (size_t i = 0; i < z.size(); ++i) z[i] = z0[i] * x0;
+    filter_raw(ext.data(), ext.data(), len, 1, z.data());
+
+    // backward with zi*y0: 只滤到第一个保留样本为止, 头部延拓段不算;
+    // up == 1 时与 filtfilt 的递推顺序完全相同, 结果逐位等于 filtfilt(x)[::q]
+    for (size_t i = 0; i < z.size(); ++i) z[i] = zi[i] * ext[len - 1];
+    filter_raw(ext.data() + len - 1, ext.data() + len - 1, len - first, -1, z.data());
+
+    std::vector<double> y(m);
+    for (size_t k = 0; k < m; ++k) y[k] = ext[first + k * (size_t)down];
     return y;
 }
 
+ButterworthFilter::Resampler ButterworthFilter::resampler(int up, int down) const {
+    if (up < 1 || down < 1) throw std::invalid_argument("resampler: up/down must be >= 1");
+    return Resampler(stream(), up, down);
+}
+
+size_t ButterworthFilter::Resampler::max_output(size_t n) const {
+    const size_t total = n * (size_t)up_;
+    return total > next_ ? (total - next_ - 1) / (size_t)down_ + 1 : 0;
+}
+
+size_t ButterworthFilter::Resampler::process(const double* x, size_t n, double* y) {
+    // 升采样样本分块放在栈上滤波, 每块只挑出保留的样本写入 y
+    constexpr size_t kChunk = 256;
+    double buf[kChunk];
+    const size_t up = (size_t)up_;
+    const size_t total = n * up;
+    size_t count = 0;
+    for (size_t u = 0; u < total; u += kChunk) {
+        const size_t c = std::min(kChunk, total - u);
+        if (up == 1) {
+            std::copy(x + u, x + u + c, buf);
+        } else {
+            const double g = (double)up_;
+            for (size_t i = 0; i < c; ++i) {
+                const size_t j = u + i;
+                buf[i] = (j % up == 0) ? g * x[j / up] : 0.0;
+            }
+        }
+        stream_.process(buf, c);
+        for (; next_ < c; next_ += (size_t)down_) y[count++] = buf[next_];
+        next_ -= c;
+    }
+    return count;
+}
+
+void ButterworthFilter::Resampler::reset() {
+    stream_.reset();
+    next_ = 0;
+}
+
 // ---------------- core helpers ----------------
 
 void ButterworthFilter::normalize_ba(std::vector<double>& b, std::vector<double>& a) {
@@ -218,10 +1553,12 @@ int ButterworthFilter::sos_ntaps(const std::vector<SOSSection>& sos) {
 }
 
 std::vector<double> ButterworthFilter::sosfilt_zi(const std::vector<SOSSection>& sos) {
-    const int nsec = (int)sos.size();
-    std::vector<double> zi((size_t)2 * (size_t)nsec, 0.0);
-    if (nsec == 0) return zi;
+    std::vector<double> zi((size_t)2 * sos.size(), 0.0);
+    sosfilt_zi_into(sos.data(), (int)sos.size(), zi.data());
+    return zi;
+}
 
+void ButterworthFilter::sosfilt_zi_into(const SOSSection* sos, int nsec, double* zi) {
     // Compute per-section DF2T zi for step response, scaled by cumulative DC gain.
     double cum_gain = 1.0;
     for (int i = 0; i < nsec; ++i) {
@@ -243,7 +1580,6 @@ std::vector<double> ButterworthFilter::sosfilt_zi(const std::vector<SOSSection>&
 
         cum_gain *= g;
     }
-    return zi;
 }
 
 int ButterworthFilter::compute_edge(int x_len, int ntaps, PadType padtype, int padlen) {
@@ -258,36 +1594,33 @@ int ButterworthFilter::compute_edge(int x_len, int ntaps, PadType padtype, int p
     return edge;
 }
 
-std::vector<double>
-ButterworthFilter::pad_extend_1d_ptr(const double* x, size_t n, int edge, PadType padtype) {
+template <class T>
+void ButterworthFilter::pad_extend_into(const T* x, size_t n, int edge, PadType padtype, T* out) {
     if (edge <= 0 || padtype == PadType::None) {
-        return std::vector<double>(x, x + n);
+        std::copy(x, x + n, out);
+        return;
     }
     if ((int)n <= edge) throw std::invalid_argument("pad_extend: n must be > edge");
 
-    std::vector<double> ext;
-    ext.reserve(n + 2ull * (size_t)edge);
-
-    const double x0 = x[0];
-    const double xN = x[n - 1];
+    const T x0 = x[0];
+    const T xN = x[n - 1];
+    T* mid = out + edge;
+    T* tail = mid + n;
+    std::copy(x, x + n, mid);
 
     if (padtype == PadType::Odd) {
-        for (int i = edge; i >= 1; --i) ext.push_back(2.0 * x0 - x[(size_t)i]);
-        ext.insert(ext.end(), x, x + n);
-        for (int i = 1; i <= edge; ++i) ext.push_back(2.0 * xN - x[n - 1ull - (size_t)i]);
-        return ext;
+        for (int i = edge; i >= 1; --i) *out++ = 2.0 * x0 - x[(size_t)i];
+        for (int i = 1; i <= edge; ++i) *tail++ = 2.0 * xN - x[n - 1ull - (size_t)i];
+        return;
     }
     if (padtype == PadType::Even) {
-        for (int i = edge; i >= 1; --i) ext.push_back(x[(size_t)i]);
-        ext.insert(ext.end(), x, x + n);
-        for (int i = 1; i <= edge; ++i) ext.push_back(x[n - 1ull - (size_t)i]);
-        return ext;
+        for (int i = edge; i >= 1; --i) *out++ = x[(size_t)i];
+        for (int i = 1; i <= edge; ++i) *tail++ = x[n - 1ull - (size_t)i];
+        return;
     }
     // Constant
-    for (int i = 0; i < edge; ++i) ext.push_back(x0);
-    ext.insert(ext.end(), x, x + n);
-    for (int i = 0; i < edge; ++i) ext.push_back(xN);
-    return ext;
+    for (int i = 0; i < edge; ++i) *out++ = x0;
+    for (int i = 0; i < edge; ++i) *tail++ = xN;
 }
 
 std::vector<double>
@@ -303,20 +1636,27 @@ ButterworthFilter::lfilter_zi(const std::vector<double>& b_in,
     a = pad_to_len(a, n + 1);
     b = pad_to_len(b, n + 1);
 
-    // (I - A) where A = companion(a).T
-    // IA[i,i]=1, IA[i,0]+=a[i+1], IA[i,i+1]-=1
-    std::vector<double> IA(n * n, 0.0);
-    for (int i = 0; i < n; ++i) {
-        IA[i * n + i] = 1.0;
-        IA[i * n + 0] += a[i + 1];
-        if (i < n - 1) IA[i * n + (i + 1)] -= 1.0;
-    }
-
-    const double b0 = b[0];
-    std::vector<double> B(n, 0.0);
-    for (int i = 0; i < n; ++i) B[i] = b[i + 1] - a[i + 1] * b0;
+    std::vector<double> zi(n);
+    lfilter_zi_into(b.data(), a.data(), n, zi.data());
+    return zi;
+}
 
-    return solve_linear(IA, B, n);
+void ButterworthFilter::lfilter_zi_into(const double* b, const double* a, int n, double* zi) {
+    // 解 (I - A) zi = B, A = companion(a).T, B[i] = b[i+1] - a[i+1] * b[0].
+    // (I - A) 第 0 列为 [1 + a1, a2, ..., an], 对角为 1, 上对角为 -1: 各行相加消去上对角,
+    // 得 zi[0] = sum(B) / sum(a) (det(I - A) = sum(a)); 再逐行回代 (同 scipy lfilter_zi 注释里的显式解)
+    double sum_a = 1.0, sum_B = 0.0;
+    for (int i = 1; i <= n; ++i) sum_a += a[i];
+    for (int i = 0; i < n; ++i) sum_B += b[i + 1] - a[i + 1] * b[0];
+    if (sum_a == 0.0) throw std::runtime_error("lfilter_zi: singular matrix");
+
+    zi[0] = sum_B / sum_a;
+    double asum = 1.0, csum = 0.0;
+    for (int k = 1; k < n; ++k) {
+        asum += a[k];
+        csum += b[k] - a[k] * b[0];
+        zi[k] = asum * zi[0] - csum;
+    }
 }
 
 std::pair<std::vector<double>, std::vector<double>>
@@ -343,16 +1683,23 @@ ButterworthFilter::lfilter_df2t(std::vector<double> b, std::vector<double> a,
     }
 
     std::vector<double> y(n, 0.0);
-    for (size_t k = 0; k < n; ++k) {
-        const double xi = x[k];
-        const double yi = b[0] * xi + z[0];
-        y[k] = yi;
+    lfilter_df2t_raw(b.data(), a.data(), order, x, y.data(), n, z.data());
+    return {y, z};
+}
+
+template <class T, class C>
+void ButterworthFilter::lfilter_df2t_raw(const C* b, const C* a, int order,
+                                         const T* x, T* y, size_t n, C* z,
+                                         std::ptrdiff_t stride) {
+    for (size_t k = 0; k < n; ++k, x += stride, y += stride) {
+        const C xi = *x;
+        const C yi = b[0] * xi + z[0];
+        *y = (T)yi;
 
         for (int i = 0; i < order - 1; ++i)
             z[i] = z[i + 1] + b[i + 1] * xi - a[i + 1] * yi;
         z[order - 1] = b[order] * xi - a[order] * yi;
     }
-    return {y, z};
 }
 
 std::pair<std::vector<double>, std::vector<double>>
@@ -371,28 +1718,35 @@ ButterworthFilter::sosfilt_df2t(const std::vector<SOSSection>& sos,
     }
 
     std::vector<double> y(n, 0.0);
-    for (size_t k = 0; k < n; ++k) {
-        double xi = x[k];
+    sosfilt_df2t_raw(sos.data(), nsec, x, y.data(), n, z.data());
+    return {y, z};
+}
+
+template <class T, class C>
+void ButterworthFilter::sosfilt_df2t_raw(const std::array<C, 6>* sos, int nsec,
+                                         const T* x, T* y, size_t n, C* z,
+                                         std::ptrdiff_t stride) {
+    for (size_t k = 0; k < n; ++k, x += stride, y += stride) {
+        C xi = *x;
         for (int si = 0; si < nsec; ++si) {
             const auto& s = sos[si];
-            const double b0 = s[0], b1 = s[1], b2 = s[2];
+            const C b0 = s[0], b1 = s[1], b2 = s[2];
             // a0 is normalized to 1
-            const double a1 = s[4], a2 = s[5];
+            const C a1 = s[4], a2 = s[5];
 
             const size_t o = (size_t)2 * (size_t)si;
-            const double z1 = z[o + 0];
-            const double z2 = z[o + 1];
+            const C z1 = z[o + 0];
+            const C z2 = z[o + 1];
 
-            const double yi = b0 * xi + z1;
-            const double new_z1 = b1 * xi - a1 * yi + z2;
-            const double new_z2 = b2 * xi - a2 * yi;
+            const C yi = b0 * xi + z1;
+            const C new_z1 = b1 * xi - a1 * yi + z2;
+            const C new_z2 = b2 * xi - a2 * yi;
             z[o + 0] = new_z1;
             z[o + 1] = new_z2;
             xi = yi;
         }
-        y[k] = xi;
+        *y = (T)xi;
     }
-    return {y, z};
 }
 
 // ---------------- 核心滤波实现 ----------------
@@ -409,100 +1763,49 @@ ButterworthFilter::lfilter_impl(const SOSKernel& k, const double* x, size_t n,
     return sosfilt_df2t(k.sos, x, n, zi);
 }
 
-std::vector<double>
-ButterworthFilter::filtfilt_impl(const BAKernel& k, const double* x, size_t n,
-                                PadType padtype, int padlen) {
-    if (k.b.empty() || k.a.empty()) throw std::invalid_argument("filtfilt: b/a empty");
-    if (n == 0) return {};
-
-    const int edge = compute_edge((int)n, k.ntaps, padtype, padlen);
-    const std::vector<double> ext = (edge > 0)
-        ? pad_extend_1d_ptr(x, n, edge, padtype)
-        : std::vector<double>(x, x + n);
-
-    // zi base: use cached if present, else compute
-    std::vector<double> zi_base = k.zi;
-    if (zi_base.empty()) zi_base = lfilter_zi(k.b, k.a);
-
-    // forward with zi*x0
-    std::vector<double> zi_f;
-    const std::vector<double>* pzi_f = nullptr;
-    if (!zi_base.empty()) {
-        zi_f.resize(zi_base.size());
-        const double x0 = ext.front();
-        for (size_t i = 0; i < zi_base.size(); ++i) zi_f[i] = zi_base[i] * x0;
-        pzi_f = &zi_f;
-    }
-
-    auto y_pair = lfilter_df2t(k.b, k.a, ext.data(), ext.size(), pzi_f);
-    std::vector<double> y = std::move(y_pair.first);
-
-    // backward with zi*y0
-    const double y0 = y.back();
-    std::reverse(y.begin(), y.end());
-
-    std::vector<double> zi_b;
-    const std::vector<double>* pzi_b = nullptr;
-    if (!zi_base.empty()) {
-        zi_b.resize(zi_base.size());
-        for (size_t i = 0; i < zi_base.size(); ++i) zi_b[i] = zi_base[i] * y0;
-        pzi_b = &zi_b;
+template <class T, class C>
+void ButterworthFilter::filtfilt_impl(const T* x, size_t n, T* y,
+                                      PadType padtype, int padlen,
+                                      const double* zi, Workspace& ws,
+                                      size_t workers) const {
+    if (mode_ == Mode::SOS) {
+        if (sos_kernel_->sos.empty()) throw std::invalid_argument("filtfilt: sos empty");
+    } else if (ba_kernel_->b.empty() || ba_kernel_->a.empty()) {
+        throw std::invalid_argument("filtfilt: b/a empty");
     }
+    if (n == 0) return;
+
+    const int ntaps = mode_ == Mode::SOS ? sos_kernel_->ntaps : ba_kernel_->ntaps;
+    const size_t edge = (size_t)compute_edge((int)n, ntaps, padtype, padlen);
+    const size_t len = n + 2 * edge;
+    const size_t ns = state_size();
+    std::vector<T>& ext_buf = workspace_buffer<T>(ws.ext_, ws.ext32_);
+    std::vector<C>& z_buf = workspace_buffer<C>(ws.z_, ws.z32_);
+    if (ext_buf.size() < len) ext_buf.resize(len);
+    if (z_buf.size() < ns) z_buf.resize(ns);
+    T* ext = ext_buf.data();
+    C* z = z_buf.data();
+
+    // 块并行只有 double 版本
+    auto pass = [&](const T* src, T* dst, size_t m, std::ptrdiff_t stride) {
+        if constexpr (std::is_same<T, double>::value && std::is_same<C, double>::value)
+            filter_pass(src, dst, m, stride, z, workers);
+        else filter_raw(src, dst, m, stride, z);
+    };
 
-    auto y2_pair = lfilter_df2t(k.b, k.a, y.data(), y.size(), pzi_b);
-    std::vector<double> y2 = std::move(y2_pair.first);
-    std::reverse(y2.begin(), y2.end());
-
-    if (edge == 0) return y2;
-    return std::vector<double>(y2.begin() + edge, y2.end() - edge);
-}
-
-std::vector<double>
-ButterworthFilter::filtfilt_impl(const SOSKernel& k, const double* x, size_t n,
-                                PadType padtype, int padlen) {
-    if (k.sos.empty()) throw std::invalid_argument("filtfilt: sos empty");
-    if (n == 0) return {};
-
-    const int edge = compute_edge((int)n, k.ntaps, padtype, padlen);
-    const std::vector<double> ext = (edge > 0)
-        ? pad_extend_1d_ptr(x, n, edge, padtype)
-        : std::vector<double>(x, x + n);
-
-    // zi base: use cached if present, else compute
-    std::vector<double> zi_base = k.zi;
-    if (zi_base.empty()) zi_base = sosfilt_zi(k.sos);
-
-    // forward with zi*x0
-    std::vector<double> zi_f;
-    const std::vector<double>* pzi_f = nullptr;
-    if (!zi_base.empty()) {
-        zi_f.resize(zi_base.size());
-        const double x0 = ext.front();
-        for (size_t i = 0; i < zi_base.size(); ++i) zi_f[i] = zi_base[i] * x0;
-        pzi_f = &zi_f;
-    }
-
-    auto y_pair = sosfilt_df2t(k.sos, ext.data(), ext.size(), pzi_f);
-    std::vector<double> y = std::move(y_pair.first);
-
-    // backward with zi*y0
-    const double y0 = y.back();
-    std::reverse(y.begin(), y.end());
-
-    std::vector<double> zi_b;
-    const std::vector<double>* pzi_b = nullptr;
-    if (!zi_base.empty()) {
-        zi_b.resize(zi_base.size());
-        for (size_t i = 0; i < zi_base.size(); ++i) zi_b[i] = zi_base[i] * y0;
-        pzi_b = &zi_b;
-    }
+    // 先把 x 读进 ext, y == x 时后面再写 y 也不会读到已覆盖的数据
+    pad_extend_into(x, n, edge, padtype, ext);
 
-    auto y2_pair = sosfilt_df2t(k.sos, y.data(), y.size(), pzi_b);
-    std::vector<double> y2 = std::move(y2_pair.first);
-    std::reverse(y2.begin(), y2.end());
+    // forward with zi*x0, 原地
+    for (size_t i = 0; i < ns; ++i) z[i] = (C)(zi[i] * ext[0]);
+    pass(ext, ext, len, 1);
 
-    if (edge == 0) return y2;
-    return std::vector<double>(y2.begin() + edge, y2.end() - edge);
+    // backward with zi*y0, stride 为 -1 时指针指向最后一个样本, 从后往前滤:
+    // 尾部延拓段只为推进状态, 原地覆盖即可; 中间 n 个样本直接写入 y;
+    // 头部延拓段的输出会被裁掉, 不必再算
+    for (size_t i = 0; i < ns; ++i) z[i] = (C)(zi[i] * ext[len - 1]);
+    filter_raw(ext + len - 1, ext + len - 1, edge, -1, z);
+    pass(ext + edge + n - 1, y + n - 1, n, -1);
 }
 
 // ============================================================
@@ -534,10 +1837,12 @@ ButterworthFilter::ComplexPair ButterworthFilter::buttap_zp(int n) {
     ComplexPair zp;
     zp.p.resize(n);
     
+    // p = -exp(j*pi*m/(2n)), m = -n+1, -n+3, ..., n-1 (同 scipy buttap):
+    // m 关于 0 对称, 共轭极点逐位相等, 奇数阶的实极点正好是 -1
     const double pi = M_PI;
     for (int k = 0; k < n; ++k) {
-        double angle = pi * (2.0 * k + n + 1.0) / (2.0 * n);
-        zp.p[k] = std::exp(std::complex<double>(0.0, angle));
+        const int m = 2 * k - n + 1;
+        zp.p[k] = -std::exp(std::complex<double>(0.0, pi * m / (2.0 * n)));
     }
     
     return zp;
@@ -660,41 +1965,14 @@ ButterworthFilter::ComplexPair ButterworthFilter::bilinear_zp(const ComplexPair&
     return result;
 }
 
-std::vector<double> ButterworthFilter::normalize_passband_gain(const std::vector<double>& b,
-                                                               const std::vector<double>& a,
-                                                               double w) {
-    // Compute H(e^{jw}) = sum(b * e^{-jwk}) / sum(a * e^{-jwk})
-    std::complex<double> num(0.0, 0.0);
-    std::complex<double> den(0.0, 0.0);
-    
-    for (size_t k = 0; k < b.size(); ++k) {
-        std::complex<double> ej = std::exp(std::complex<double>(0.0, -w * (double)k));
-        num += b[k] * ej;
-    }
-    
-    for (size_t k = 0; k < a.size(); ++k) {
-        std::complex<double> ej = std::exp(std::complex<double>(0.0, -w * (double)k));
-        den += a[k] * ej;
-    }
-    
-    std::complex<double> H = num / den;
-    double gain = 1.0 / (std::abs(H) + 1e-30);
-    
-    std::vector<double> b_norm(b.size());
-    for (size_t i = 0; i < b.size(); ++i) {
-        b_norm[i] = b[i] * gain;
-    }
-    
-    return b_norm;
-}
-
-std::pair<std::vector<double>, std::vector<double>>
-ButterworthFilter::butter_ba(int order, double fs, const std::string& btype, const std::vector<double>& cutoff) {
+ButterworthFilter::ComplexPair
+ButterworthFilter::butter_zp(int order, double fs, const std::string& btype, const std::vector<double>& cutoff,
+                             double& w_norm) {
     if (order <= 0) {
         throw std::invalid_argument("order must be positive");
     }
-    if (fs <= 0.0) {
-        throw std::invalid_argument("fs must be > 0");
+    if (!(is_finite_bits(fs) && fs > 0.0)) {
+        throw std::invalid_argument("fs must be finite and > 0");
     }
     
     const double fs2 = 2.0 * fs;
@@ -702,7 +1980,7 @@ ButterworthFilter::butter_ba(int order, double fs, const std::string& btype, con
     
     // Prewarp function
     auto prewarp = [&](double f_hz) {
-        if (f_hz <= 0.0 || f_hz >= 0.5 * fs) {
+        if (!(is_finite_bits(f_hz) && f_hz > 0.0 && f_hz < 0.5 * fs)) {
             throw std::invalid_argument("cutoff must satisfy 0 < f < fs/2");
         }
         return fs2 * std::tan(pi * f_hz / fs);
@@ -712,7 +1990,7 @@ ButterworthFilter::butter_ba(int order, double fs, const std::string& btype, con
     ComplexPair zp = buttap_zp(order);
     
     // 2) Analog frequency transform
-    double w_norm = 0.0;
+    w_norm = 0.0;
     
     if (btype == "lowpass" || btype == "highpass") {
         if (cutoff.size() != 1) {
@@ -753,23 +2031,138 @@ ButterworthFilter::butter_ba(int order, double fs, const std::string& btype, con
     }
     
     // 3) Bilinear transform (analog -> digital)
-    zp = bilinear_zp(zp, fs);
-    
-    // 4) zpk -> ba
-    std::vector<double> b = poly(zp.z);
-    std::vector<double> a = poly(zp.p);
-    
-    // Normalize a[0] = 1
-    if (a.empty() || a[0] == 0.0) {
-        throw std::runtime_error("butter_ba: invalid denominator");
+    return bilinear_zp(zp, fs);
+}
+
+std::vector<ButterworthFilter::SOSSection>
+ButterworthFilter::butter_sos(int order, double fs, const std::string& btype, const std::vector<double>& cutoff) {
+    double w_norm = 0.0;
+    std::vector<SOSSection> sos = zp2sos(butter_zp(order, fs, btype, cutoff, w_norm));
+
+    // 通带增益归一化: H(e^{jw}) 为各节之积, 增益放在第一节
+    std::complex<double> H(1.0, 0.0);
+    const std::complex<double> e1 = std::exp(std::complex<double>(0.0, -w_norm));
+    const std::complex<double> e2 = e1 * e1;
+    for (const auto& s : sos)
+        H *= (s[0] + s[1] * e1 + s[2] * e2) / (s[3] + s[4] * e1 + s[5] * e2);
+    const double gain = 1.0 / (std::abs(H) + 1e-30);
+    for (int i = 0; i < 3; ++i) sos[0][i] *= gain;
+    return sos;
+}
+
+std::vector<ButterworthFilter::SOSSection> ButterworthFilter::zp2sos(const ComplexPair& zp) {
+    using cplx = std::complex<double>;
+    std::vector<cplx> z = zp.z, p = zp.p;
+
+    // 零极点补到一样多且为偶数, 多出来的放在原点
+    while (z.size() < p.size()) z.push_back(0.0);
+    while (p.size() < z.size()) p.push_back(0.0);
+    if (p.size() % 2 == 1) {
+        p.push_back(0.0);
+        z.push_back(0.0);
     }
-    
-    double a0 = a[0];
-    for (size_t i = 0; i < b.size(); ++i) b[i] /= a0;
-    for (size_t i = 0; i < a.size(); ++i) a[i] /= a0;
-    
-    // 5) Normalize passband gain
-    b = normalize_passband_gain(b, a, w_norm);
-    
-    return {b, a};
+    const int nsec = (int)p.size() / 2;
+    if (nsec == 0) return {SOSSection{1.0, 0.0, 0.0, 1.0, 0.0, 0.0}};
+
+    // 共轭对只留虚部为正的一个 (取两者平均), 实根虚部置零; 先复根 (按实部、|虚部| 排序) 后实根 (同 scipy _cplxreal)
+    // 容差对 |x| < 1 取绝对值, 否则原点附近的实根会被当成复根; 配不上共轭的根直接报错
+    auto cplxreal = [](const std::vector<cplx>& v) {
+        const double tol = 100.0 * std::numeric_limits<double>::epsilon();
+        std::vector<cplx> c, r, neg;
+        for (const cplx& x : v) {
+            if (std::fabs(x.imag()) <= tol * std::max(std::abs(x), 1.0)) r.emplace_back(x.real(), 0.0);
+            else if (x.imag() > 0.0) c.push_back(x);
+            else neg.push_back(x);
+        }
+        for (cplx& x : c) {
+            size_t best = neg.size();
+            for (size_t i = 0; i < neg.size(); ++i) {
+                if (best == neg.size() || std::abs(x - std::conj(neg[i])) < std::abs(x - std::conj(neg[best]))) best = i;
+            }
+            if (best == neg.size() || std::abs(x - std::conj(neg[best])) > tol * std::max(std::abs(x), 1.0)) {
+                throw std::runtime_error("zp2sos: complex root without conjugate");
+            }
+            x = 0.5 * (x + std::conj(neg[best]));
+            neg.erase(neg.begin() + (std::ptrdiff_t)best);
+        }
+        if (!neg.empty()) throw std::runtime_error("zp2sos: complex root without conjugate");
+        std::sort(c.begin(), c.end(), [](const cplx& a, const cplx& b) {
+            return a.real() != b.real() ? a.real() < b.real() : std::fabs(a.imag()) < std::fabs(b.imag());
+        });
+        std::sort(r.begin(), r.end(), [](const cplx& a, const cplx& b) { return a.real() < b.real(); });
+        c.insert(c.end(), r.begin(), r.end());
+        return c;
+    };
+    z = cplxreal(z);
+    p = cplxreal(p);
+
+    auto is_real = [](const cplx& v) { return v.imag() == 0.0; };
+    auto count_real = [&](const std::vector<cplx>& v) {
+        return (size_t)std::count_if(v.begin(), v.end(), is_real);
+    };
+    // 离单位圆最近的极点 (最 "危险"), only_real 时只在实极点中找
+    auto idx_worst = [&](const std::vector<cplx>& v, bool only_real) {
+        size_t best = v.size();
+        for (size_t i = 0; i < v.size(); ++i) {
+            if (only_real && !is_real(v[i])) continue;
+            if (best == v.size() || std::fabs(1.0 - std::abs(v[i])) < std::fabs(1.0 - std::abs(v[best]))) best = i;
+        }
+        if (best == v.size()) throw std::runtime_error("zp2sos: cannot pair poles");
+        return best;
+    };
+    // 离 to 最近的零点; which: 0 任意, 1 仅实数, 2 仅复数
+    auto idx_nearest = [&](const std::vector<cplx>& v, cplx to, int which) {
+        size_t best = v.size();
+        for (size_t i = 0; i < v.size(); ++i) {
+            if ((which == 1 && !is_real(v[i])) || (which == 2 && is_real(v[i]))) continue;
+            if (best == v.size() || std::abs(v[i] - to) < std::abs(v[best] - to)) best = i;
+        }
+        if (best == v.size()) throw std::runtime_error("zp2sos: cannot pair zeros with poles");
+        return best;
+    };
+    auto take = [](std::vector<cplx>& v, size_t i) {
+        const cplx x = v[i];
+        v.erase(v.begin() + (std::ptrdiff_t)i);
+        return x;
+    };
+    // 至多两个零点/极点组成一节, 系数右对齐 (同 scipy _single_zpksos)
+    auto section = [](const std::vector<cplx>& zs, const std::vector<cplx>& ps) {
+        SOSSection sec{0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        const std::vector<double> b = poly(zs), a = poly(ps);
+        for (size_t i = 0; i < b.size(); ++i) sec[3 - b.size() + i] = b[i];
+        for (size_t i = 0; i < a.size(); ++i) sec[6 - a.size() + i] = a[i];
+        return sec;
+    };
+
+    // 从最后一节往前填, 离单位圆最近的极点放在最后
+    std::vector<SOSSection> sos(nsec);
+    for (int si = nsec - 1; si >= 0; --si) {
+        const cplx p1 = take(p, idx_worst(p, false));
+
+        if (is_real(p1) && count_real(p) == 0) {
+            // 最后一个实极点, 配一个实零点成一阶节
+            const cplx z1 = take(z, idx_nearest(z, p1, 1));
+            sos[si] = section({z1, 0.0}, {p1, 0.0});
+        } else if (p.size() + 1 == z.size() && !is_real(p1) && count_real(p) == 1 && count_real(z) == 1) {
+            // 只剩一个实极点和一个实零点, 这里必须配复零点
+            const cplx z1 = take(z, idx_nearest(z, p1, 2));
+            sos[si] = section({z1, std::conj(z1)}, {p1, std::conj(p1)});
+        } else {
+            const cplx p2 = is_real(p1) ? take(p, idx_worst(p, true)) : std::conj(p1);
+            if (z.empty()) {
+                sos[si] = section({}, {p1, p2});
+                continue;
+            }
+            const cplx z1 = take(z, idx_nearest(z, p1, 0));
+            if (!is_real(z1)) {
+                sos[si] = section({z1, std::conj(z1)}, {p1, p2});
+            } else if (!z.empty()) {
+                const cplx z2 = take(z, idx_nearest(z, p1, 1));
+                sos[si] = section({z1, z2}, {p1, p2});
+            } else {
+                sos[si] = section({z1}, {p1, p2});
+            }
+        }
+    }
+    return sos;
 }
@@ -0,0 +1,111 @@
+#include "detrend.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// 一段 m 个样本去趋势. 横轴以段中点为原点, sum(t) = 0, 斜率与截距互不耦合,
+// 不必累加 sum(t^2) 这种随长度立方增长的量, 长信号也不损失精度
+static void detrend_segment(const double* x, size_t m, double* y, DetrendType type) {
+    if (m == 0) return;
+    double sum = 0.0;
+    for (size_t i = 0; i < m; ++i) sum += x[i];
+    const double mean = sum / (double)m;
+    if (type == DetrendType::Constant) {
+        for (size_t i = 0; i < m; ++i) y[i] = x[i] - mean;
+        return;
+    }
+
+    const double M = (double)m;
+    const double tc = 0.5 * (M - 1.0);
+    const double stt = M * (M * M - 1.0) / 12.0;   // sum((t - tc)^2)
+    double sty = 0.0;
+    for (size_t i = 0; i < m; ++i) sty += ((double)i - tc) * x[i];
+    const double slope = stt > 0.0 ? sty / stt : 0.0;
+    for (size_t i = 0; i < m; ++i) y[i] = x[i] - (mean + slope * ((double)i - tc));
+}
+
+} // namespace
+
+void detrend(const double* x, size_t n, double* y, DetrendType type, const std::vector<size_t>& bp) {
+    if (type == DetrendType::Constant || bp.empty()) {
+        detrend_segment(x, n, y, type);
+        return;
+    }
+
+    // 同 scipy: 断点连同 0 与 n 排序去重, 相邻两个断点之间为一段
+    std::vector<size_t> edges(bp);
+    if (std::any_of(edges.begin(), edges.end(), [n](size_t b) { return b > n; }))
+        throw std::invalid_argument("detrend: breakpoints must be <= len(x)");
+    edges.push_back(0);
+    edges.push_back(n);
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    for (size_t i = 0; i + 1 < edges.size(); ++i)
+        detrend_segment(x + edges[i], edges[i + 1] - edges[i], y + edges[i], type);
+}
+
+std::vector<double> detrend(const double* x, size_t n, DetrendType type, const std::vector<size_t>& bp) {
+    std::vector<double> y(n);
+    detrend(x, n, y.data(), type, bp);
+    return y;
+}
+
+// ---------------- sliding detrend ----------------
+
+SlidingDetrend::SlidingDetrend(size_t window, DetrendType type)
+    : window_(window), type_(type) {
+    if (window == 0) throw std::invalid_argument("SlidingDetrend: window must be >= 1");
+    buf_.assign(window, 0.0);
+}
+
+double SlidingDetrend::update(double x) {
+    if (count_ < window_) {
+        buf_[(head_ + count_) % window_] = x;
+        s0_ += x;
+        s1_ += (double)count_ * x;
+        ++count_;
+    } else {
+        // 最老的样本移出, 其余样本下标各减 1: sum(k * x) 减去剩下样本之和, 新样本的下标为 window - 1
+        const double old = buf_[head_];
+        buf_[head_] = x;
+        head_ = head_ + 1 == window_ ? 0 : head_ + 1;
+        s1_ += (double)(window_ - 1) * x - (s0_ - old);
+        s0_ += x - old;
+        if (++since_sync_ >= window_) resync();
+    }
+
+    const double c = (double)count_;
+    const double mean = s0_ / c;
+    if (type_ == DetrendType::Constant || count_ < 2) return x - mean;
+    // 拟合直线在最新样本 (k = c - 1) 处的值: mean + slope * (c - 1 - tc), 其中 c - 1 - tc = tc
+    const double tc = 0.5 * (c - 1.0);
+    const double stt = c * (c * c - 1.0) / 12.0;
+    const double slope = (s1_ - tc * s0_) / stt;
+    return x - (mean + slope * tc);
+}
+
+void SlidingDetrend::process(const double* x, double* y, size_t n) {
+    for (size_t i = 0; i < n; ++i) y[i] = update(x[i]);
+}
+
+void SlidingDetrend::reset() {
+    std::fill(buf_.begin(), buf_.end(), 0.0);
+    head_ = 0;
+    count_ = 0;
+    since_sync_ = 0;
+    s0_ = 0.0;
+    s1_ = 0.0;
+}
+
+void SlidingDetrend::resync() {
+    double s0 = 0.0, s1 = 0.0;
+    for (size_t k = 0; k < count_; ++k) {
+        const double v = buf_[(head_ + k) % window_];
+        s0 += v;
+        s1 += (double)k * v;
+    }
+    s0_ = s0;
+    s1_ = s1;
+    since_sync_ = 0;
+}
@@ -0,0 +1,55 @@
+#ifndef DETREND_HPP
+#define DETREND_HPP
+
+#include <cstddef>
+#include <vector>
+
+// 去趋势 (同 scipy.signal.detrend), 可放在 filtfilt 之前做预处理:
+// 输出可以就是输入 (原地处理), 之后再用 ButterworthFilter::filtfilt(x, n, x, ws) 原地滤波, 全程不额外拷贝.
+
+enum class DetrendType {
+    Linear,     // 减去最小二乘直线
+    Constant    // 减去均值
+};
+
+// y[0..n) = x 去趋势, y 可以等于 x.
+// bp 为分段断点 (Linear 时有效, 同 scipy 的 bp): 断点排序去重后把 [0, n) 切成若干段, 每段各自拟合直线;
+// 断点须在 [0, n] 内, 否则抛 std::invalid_argument.
+void detrend(const double* x, size_t n, double* y,
+             DetrendType type = DetrendType::Linear,
+             const std::vector<size_t>& bp = {});
+
+std::vector<double> detrend(const double* x, size_t n,
+                            DetrendType type = DetrendType::Linear,
+                            const std::vector<size_t>& bp = {});
+
+// 滑动窗口去趋势 (流式, 因果): 每来一个样本, 用最近 window 个样本 (不足时用已有的) 拟合直线或求均值,
+// 输出该样本减去拟合值在当前时刻的取值.
+// 窗口内 sum(x) 与 sum(k * x) 随滑动增量更新, 每个样本 O(1); 每滑过 window 个样本从环形缓冲区重算一次,
+// 不让加减累积的舍入误差漂移. process() 不做堆分配, 输入输出可以是同一块内存.
+class SlidingDetrend {
+public:
+    explicit SlidingDetrend(size_t window, DetrendType type = DetrendType::Linear);
+
+    void process(const double* x, double* y, size_t n);
+    void process(double* xy, size_t n) { process(xy, xy, n); }
+    double update(double x);
+
+    size_t window() const { return window_; }
+    // 清空窗口
+    void reset();
+
+private:
+    void resync();
+
+    size_t window_;
+    DetrendType type_;
+    std::vector<double> buf_;   // 环形缓冲区, head_ 处是最老的样本
+    size_t head_ = 0;
+    size_t count_ = 0;          // 窗口内样本数 (<= window_)
+    size_t since_sync_ = 0;
+    double s0_ = 0.0;           // sum(x)
+    double s1_ = 0.0;           // sum(k * x), k 为窗口内下标, 最老的样本 k = 0
+};
+
+#endif // DETREND_HPP
@@ -0,0 +1,45 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_ALLOC_COUNTER_H
+#define FFALCONXR_ALLOC_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Counting replacements of the global operator new/delete, shared by the dsp
+// benchmarks: g_allocs is read before and after a timed loop to report
+// allocs/sample. Include from exactly one translation unit per executable.
+static std::atomic<long long> g_allocs(0);
+
+// GCC pairs the malloc below with the free in operator delete and warns
+// (-Wmismatched-new-delete) once the replacements are inlined into callers.
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wunknown-warning-option"
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif //FFALCONXR_ALLOC_COUNTER_H
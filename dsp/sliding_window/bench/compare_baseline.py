@@ -0,0 +1,101 @@
+#!/usr/bin/env python
+# encoding: utf-8
+"""
+Compare two sliding_window_benchmark / pybind_benchmark.py runs made on the
+same machine, e.g. the build before and after a change.
+
+Absolute ns/sample numbers do not carry over between machines, so there is no
+committed baseline: record one with the old build and compare the new build
+against it. Inputs are google benchmark JSON files (--benchmark_out_format=json,
+run with --benchmark_repetitions so the median and cv aggregates exist) or the
+output of pybind_benchmark.py. A case regresses when
+  - its ns/sample grows by more than --threshold plus the noise of both runs
+    (cv of the repetitions, or the spread reported by pybind_benchmark.py),
+  - it allocates per sample (C++ operator new) and the baseline did not, or
+  - its Python heap use (alloc_bytes/sample) grows by more than --alloc-bytes.
+Exits with status 1 if anything regressed.
+
+	sliding_window_benchmark --benchmark_repetitions=5 --benchmark_enable_random_interleaving=true \
+		--benchmark_out=base.json --benchmark_out_format=json        # old build
+	(same for the new build into result.json)
+	python bench/compare_baseline.py base.json result.json
+	python bench/compare_baseline.py py_base.json py_result.json     # pybind_benchmark.py --out
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_results(paths):
+	results = {}
+	noise = {}
+	for path in paths:
+		with open(path) as f:
+			data = json.load(f)
+		for b in data['benchmarks']:
+			name = b.get('run_name', b['name'])
+			if b.get('run_type') == 'aggregate':
+				# with --benchmark_repetitions only the median carries the number, the cv its spread
+				if b.get('aggregate_name') == 'cv':
+					noise[name] = b.get('items_per_second', 0.0)
+				if b.get('aggregate_name') != 'median':
+					continue
+			results[name] = {
+				'ns_per_sample': 1e9 / b['items_per_second'],
+				'allocs_per_sample': b.get('allocs/sample', 0.0),
+				'alloc_bytes_per_sample': b.get('alloc_bytes/sample', 0.0),
+				'noise': b.get('noise', 0.0),
+			}
+	for name, cv in noise.items():
+		if name in results:
+			results[name]['noise'] = cv
+	return results
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+	parser.add_argument('baseline', help='results of the reference build on this machine')
+	parser.add_argument('results', nargs='+')
+	parser.add_argument('--threshold', type=float, default=0.10,
+						help='allowed relative slowdown on top of the measured noise (default 0.10)')
+	parser.add_argument('--alloc-bytes', type=float, default=0.5,
+						help='allowed growth of Python heap bytes per sample (default 0.5)')
+	args = parser.parse_args()
+
+	current = load_results(args.results)
+	baseline = load_results([args.baseline])
+
+	regressions = 0
+	print('%-40s %12s %12s %8s %8s' % ('case', 'base ns', 'now ns', 'change', 'allowed'))
+	for name in sorted(current):
+		now = current[name]
+		base = baseline.get(name)
+		if base is None:
+			print('%-40s %12s %12.2f %8s' % (name, '-', now['ns_per_sample'], 'new'))
+			continue
+		change = now['ns_per_sample'] / base['ns_per_sample'] - 1.0
+		allowed = args.threshold + base['noise'] + now['noise']
+		reasons = []
+		if change > allowed:
+			reasons.append('slower')
+		if now['allocs_per_sample'] > 0 and base['allocs_per_sample'] == 0:
+			reasons.append('allocates')
+		if now['alloc_bytes_per_sample'] > base['alloc_bytes_per_sample'] + args.alloc_bytes:
+			reasons.append('python heap %.2f -> %.2f bytes/sample'
+						   % (base['alloc_bytes_per_sample'], now['alloc_bytes_per_sample']))
+		flag = ''
+		if reasons:
+			flag = ' REGRESSION (%s)' % ', '.join(reasons)
+			regressions += 1
+		print('%-40s %12.2f %12.2f %+7.1f%% %7.1f%%%s' % (
+			name, base['ns_per_sample'], now['ns_per_sample'], 100 * change, 100 * allowed, flag))
+	for name in sorted(set(baseline) - set(current)):
+		print('%-40s missing from results' % name)
+
+	print('%d regression(s)' % regressions)
+	return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())
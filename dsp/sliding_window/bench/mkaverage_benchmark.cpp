@@ -0,0 +1,129 @@
+//
+// Created by wayne on 2026/10/16.
+//
+// Per-sample latency and heap allocations of MKAverage against the previous
+// three-multiset implementation, for window sizes m = 64 .. 65536.
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <vector>
+#include "MKAverage.h"
+#include "alloc_counter.h"
+
+// reference: the multiset based MKAverage this library used to ship
+class MultisetMKAverage {
+public:
+    MultisetMKAverage(int m, int k) : m(m), k(k), sz(m - 2 * k), v(m) {}
+
+    void addElement(double num) {
+        if (pos >= m) remove(v[pos % m]);
+        add(num);
+        v[pos++ % m] = num;
+    }
+
+    double calculateMKAverage() {
+        if (pos < m) return 0.0f;
+        return sum / (float) sz;
+    }
+
+private:
+    void remove(double n) {
+        if (n <= *left.rbegin())
+            left.erase(left.find(n));
+        else if (n <= *mid.rbegin()) {
+            auto it = mid.find(n);
+            sum -= *it;
+            mid.erase(it);
+        } else
+            right.erase(right.find(n));
+        if ((int) left.size() < k) {
+            left.insert(*begin(mid));
+            sum -= *begin(mid);
+            mid.erase(begin(mid));
+        }
+        if ((int) mid.size() < sz) {
+            mid.insert(*begin(right));
+            sum += *begin(right);
+            right.erase(begin(right));
+        }
+    }
+
+    void add(double n) {
+        left.insert(n);
+        if ((int) left.size() > k) {
+            auto it = prev(end(left));
+            mid.insert(*it);
+            sum += *it;
+            left.erase(it);
+        }
+        if ((int) mid.size() > sz) {
+            auto it = prev(end(mid));
+            sum -= *it;
+            right.insert(*it);
+            mid.erase(it);
+        }
+    }
+
+    int m, k, sz, pos = 0;
+    double sum = 0;
+    std::vector<double> v;
+    std::multiset<double> left, mid, right;
+};
+
+struct Result {
+    double nsPerSample;
+    double allocsPerSample;
+    double checksum;
+};
+
+template<typename T>
+static Result run(int m, int k, const std::vector<double> &data) {
+    T avg(m, k);
+    // warm up: fill the window once so steady-state costs are measured
+    for (int i = 0; i < m; ++i) avg.addElement(data[i]);
+
+    const long long allocs0 = g_allocs.load();
+    const auto t0 = std::chrono::steady_clock::now();
+    double checksum = 0.0;
+    for (size_t i = m; i < data.size(); ++i) {
+        avg.addElement(data[i]);
+        checksum += avg.calculateMKAverage();
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const long long allocs1 = g_allocs.load();
+
+    const double n = (double) (data.size() - m);
+    return {std::chrono::duration<double, std::nano>(t1 - t0).count() / n,
+            (double) (allocs1 - allocs0) / n,
+            checksum};
+}
+
+int main(int argc, char **argv) {
+    const size_t samples = argc > 1 ? (size_t) std::atoll(argv[1]) : (size_t) 1 << 20;
+
+    std::printf("%8s %8s | %14s %14s | %14s %14s | %8s\n",
+                "m", "k", "multiset ns", "multiset alloc", "blocked ns", "blocked alloc", "speedup");
+    for (int m = 64; m <= 65536; m *= 4) {
+        const int k = m / 8;
+        std::mt19937_64 gen(42);
+        std::normal_distribution<double> dist(0.0, 1.0);
+        std::vector<double> data(m + samples);
+        for (double &x : data) x = dist(gen);
+
+        const Result ref = run<MultisetMKAverage>(m, k, data);
+        const Result cur = run<MKAverage>(m, k, data);
+        if (std::abs(ref.checksum - cur.checksum) > 1e-6 * (1.0 + std::abs(ref.checksum))) {
+            std::fprintf(stderr, "checksum mismatch at m=%d: %.12g vs %.12g\n", m, ref.checksum, cur.checksum);
+            return 1;
+        }
+        std::printf("%8d %8d | %14.1f %14.3f | %14.1f %14.3f | %7.2fx\n",
+                    m, k, ref.nsPerSample, ref.allocsPerSample, cur.nsPerSample, cur.allocsPerSample,
+                    ref.nsPerSample / cur.nsPerSample);
+    }
+    return 0;
+}
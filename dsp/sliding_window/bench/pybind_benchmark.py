@@ -0,0 +1,100 @@
+#!/usr/bin/env python
+# encoding: utf-8
+"""
+Per-call cost of the pybind module: one Python call per sample versus one
+process() call per array, for WelfordStd, MonoQueue and MKAverage.
+
+Writes the same JSON layout as google benchmark (name + items_per_second,
+plus noise), so compare_baseline.py can compare two runs made on the same
+machine. Each case
+also reports alloc_bytes/sample: the peak Python heap growth (numpy buffers,
+boxed floats) seen by tracemalloc during one untimed run, divided by the
+sample count. process() with out= should stay at 0; allocations made by the
+C++ side with operator new are counted by sliding_window_benchmark instead.
+
+	python bench/pybind_benchmark.py --out pybind_result.json
+"""
+
+import argparse
+import json
+import os
+import sys
+import time
+import tracemalloc
+
+import numpy as np
+
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'lib'))
+import sliding_window_dsp
+
+
+def best_rate(fn, samples, repeat):
+	# fastest run; noise is how far the median run lags behind it
+	times = []
+	for _ in range(max(repeat, 1)):
+		t0 = time.perf_counter()
+		fn()
+		times.append(time.perf_counter() - t0)
+	times.sort()
+	best, median = times[0], times[len(times) // 2]
+	return samples / best, (median - best) / best
+
+
+def alloc_bytes(fn, samples):
+	# separate untimed run: tracing every allocation would distort the timing
+	tracemalloc.start()
+	try:
+		start = tracemalloc.get_traced_memory()[0]
+		tracemalloc.reset_peak()
+		fn()
+		return (tracemalloc.get_traced_memory()[1] - start) / samples
+	finally:
+		tracemalloc.stop()
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+	parser.add_argument('--out', help='write results as JSON to this file')
+	parser.add_argument('--win', type=int, default=1024)
+	parser.add_argument('--samples', type=int, default=1 << 16)
+	parser.add_argument('--repeat', type=int, default=5)
+	args = parser.parse_args()
+
+	x = np.random.default_rng(42).standard_normal(args.samples)
+	xs = x.tolist()
+	win = args.win
+	cases = [
+		('WelfordStd', lambda: sliding_window_dsp.WelfordStd(win), 'calcSlidingStd'),
+		('MonoQueue', lambda: sliding_window_dsp.MonoQueue(win), 'push'),
+		('MKAverage', lambda: sliding_window_dsp.MKAverage(win, win // 8), 'addElement'),
+	]
+
+	results = []
+	for name, make, method in cases:
+		obj = make()
+		obj.process(x[:win])
+		step = getattr(obj, method)
+
+		def per_call():
+			for v in xs:
+				step(v)
+
+		out = np.empty_like(x)
+		paths = {
+			'per_call': per_call,
+			'process': lambda: obj.process(x, out=out),
+		}
+		for path, fn in paths.items():
+			bench = 'py/%s/%s/%d' % (name, path, win)
+			rate, noise = best_rate(fn, args.samples, args.repeat)
+			alloc = alloc_bytes(fn, args.samples)
+			results.append({'name': bench, 'items_per_second': rate, 'noise': noise, 'alloc_bytes/sample': alloc})
+			print('%-36s %10.1f ns/sample %8.3f alloc bytes/sample' % (bench, 1e9 / rate, alloc))
+
+	if args.out:
+		with open(args.out, 'w') as f:
+			json.dump({'benchmarks': results}, f, indent=2)
+
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,291 @@
+//
+// Created by wayne on 2026/10/16.
+//
+// Google-benchmark suite for WelfordStd, MonoQueue and MKAverage.
+// Every case streams a fixed input through process() in blocks, so the
+// window is always full, and reports
+//   items_per_second  -> 1e9 / items_per_second is ns/sample
+//   allocs/sample     -> heap allocations per sample inside the timed loop
+// BM_Separate* / BM_Pipeline* compare chained WelfordStd, MonoQueue and
+// MKAverage objects on one stream against the fused SlidingPipeline; the run
+// exits with status 1 when a pipeline case has fewer items_per_second than the
+// separate objects at the same window (best repetition or median).
+// Inputs: random, ascending, descending, constant and a sensor replay. The
+// replay is a synthetic quantized accelerometer trace unless
+// SLIDING_WINDOW_REPLAY names a text file of whitespace separated samples
+// (tiled up to 65536 samples when shorter).
+//
+// Timings only compare on one machine: run the old and the new build with
+// --benchmark_repetitions=5 --benchmark_out=<file> --benchmark_out_format=json
+// and compare the two files with bench/compare_baseline.py.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "MKAverage.h"
+#include "MonoQueue.h"
+#include "SlidingPipeline.h"
+#include "WelfordStd.h"
+#include "alloc_counter.h"
+
+namespace {
+
+const size_t kInputLen = 1 << 16;
+const size_t kBlock = 4096;
+
+enum Input {
+    Random, Ascending, Descending, Constant, Replay
+};
+
+std::vector<double> replayTrace() {
+    std::vector<double> x;
+    if (const char *path = std::getenv("SLIDING_WINDOW_REPLAY")) {
+        std::ifstream in(path);
+        double v;
+        while (in >> v) x.push_back(v);
+    }
+    if (!x.empty()) {
+        // short recordings are tiled so the blocked loop in run() always has kInputLen samples to walk
+        const size_t n = x.size();
+        x.reserve(kInputLen);
+        while (x.size() < kInputLen) x.push_back(x[x.size() - n]);
+        return x;
+    }
+
+    // 100 Hz accelerometer z axis, 16 bit at +-8 g: gravity, walking, noise,
+    // and an occasional impact spike. Quantization gives many equal values.
+    std::mt19937 gen(7);
+    std::normal_distribution<double> noise(0.0, 0.05);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    const double lsb = 16.0 * 9.80665 / 65536.0;
+    x.resize(kInputLen);
+    for (size_t i = 0; i < kInputLen; ++i) {
+        const double t = (double) i / 100.0;
+        double a = 9.80665 + 1.5 * std::sin(2 * M_PI * 1.8 * t) + 0.4 * std::sin(2 * M_PI * 0.2 * t) + noise(gen);
+        if (u(gen) < 0.002) a += 30.0 * u(gen);
+        x[i] = std::round(a / lsb) * lsb;
+    }
+    return x;
+}
+
+const std::vector<double> &input(Input kind) {
+    static std::vector<double> inputs[5];
+    std::vector<double> &x = inputs[kind];
+    if (!x.empty()) return x;
+    std::mt19937 gen(42);
+    std::normal_distribution<double> nd;
+    switch (kind) {
+        case Random:
+            x.resize(kInputLen);
+            for (auto &v : x) v = nd(gen);
+            break;
+        case Ascending:
+        case Descending:
+            x.resize(kInputLen);
+            for (size_t i = 0; i < kInputLen; ++i) x[i] = kind == Ascending ? (double) i : -(double) i;
+            break;
+        case Constant:
+            x.assign(kInputLen, 1.0);
+            break;
+        case Replay:
+            x = replayTrace();
+            break;
+    }
+    return x;
+}
+
+// feed the window once, then time process() over kBlock sample blocks
+template<typename Window>
+void run(benchmark::State &state, Window &w, Input kind, int warmup) {
+    const std::vector<double> &x = input(kind);
+    std::vector<double> out(kBlock);
+    size_t pos = 0;
+    for (int i = 0; i < warmup; ++i) {
+        w.process(&x[pos], 1, out.data());
+        pos = (pos + 1) % (x.size() - kBlock);
+    }
+    // counted around process() only, the benchmark harness allocates on its own
+    long long allocs = 0;
+    for (auto _ : state) {
+        const long long before = g_allocs.load(std::memory_order_relaxed);
+        w.process(&x[pos], kBlock, out.data());
+        allocs += g_allocs.load(std::memory_order_relaxed) - before;
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+        pos += kBlock;
+        if (pos + kBlock > x.size()) pos = 0;
+    }
+    const double samples = (double) state.iterations() * kBlock;
+    state.SetItemsProcessed((int64_t) samples);
+    state.counters["allocs/sample"] = (double) allocs / samples;
+}
+
+template<Input kind>
+void BM_WelfordStd(benchmark::State &state) {
+    const int win = (int) state.range(0);
+    WelfordStd w(win);
+    run(state, w, kind, win);
+}
+
+template<Input kind>
+void BM_MonoQueue(benchmark::State &state) {
+    const int win = (int) state.range(0);
+    MonoQueue w(win);
+    run(state, w, kind, win);
+}
+
+template<Input kind>
+void BM_MKAverage(benchmark::State &state) {
+    const int m = (int) state.range(0);
+    MKAverage w(m, m / 8);
+    run(state, w, kind, m);
+}
+
+// the objects a caller would otherwise chain, each buffering the window
+template<bool Trimmed>
+struct Separate {
+    Separate(int win) : std(win), max(win), negMax(win), trimmed(win, 8) {}
+
+    void process(const double *x, size_t n, double *out) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = std.calcSlidingStd(x[i]) + std.avg;
+            max.push(x[i]);
+            out[i] += max.max();
+            if (Trimmed) {
+                trimmed.addElement(x[i]);
+                out[i] += trimmed.calculateMKAverage();
+            } else {
+                negMax.push(-x[i]);
+                out[i] -= negMax.max();
+            }
+        }
+    }
+
+    WelfordStd std;
+    MonoQueue max;
+    MonoQueue negMax;
+    MKAverage trimmed;
+};
+
+template<bool Trimmed>
+struct Fused {
+    using Last = typename std::conditional<Trimmed, stat::TrimmedMean<8>, stat::Min>::type;
+
+    Fused(int win) : pipeline(win) {}
+
+    void process(const double *x, size_t n, double *out) {
+        for (size_t i = 0; i < n; ++i) {
+            pipeline.push(x[i]);
+            out[i] = pipeline.template value<0>() + pipeline.template value<1>() +
+                     pipeline.template value<2>() + pipeline.template value<3>();
+        }
+    }
+
+    SlidingPipeline<stat::Mean, stat::Std, stat::Max, Last> pipeline;
+};
+
+// Mean, Std, Max and Min
+template<Input kind>
+void BM_Separate(benchmark::State &state) {
+    const int win = (int) state.range(0);
+    Separate<false> w(win);
+    run(state, w, kind, win);
+}
+
+template<Input kind>
+void BM_Pipeline(benchmark::State &state) {
+    const int win = (int) state.range(0);
+    Fused<false> w(win);
+    run(state, w, kind, win);
+}
+
+// Mean, Std, Max and TrimmedMean<8>
+template<Input kind>
+void BM_SeparateTrimmed(benchmark::State &state) {
+    const int win = (int) state.range(0);
+    Separate<true> w(win);
+    run(state, w, kind, win);
+}
+
+template<Input kind>
+void BM_PipelineTrimmed(benchmark::State &state) {
+    const int win = (int) state.range(0);
+    Fused<true> w(win);
+    run(state, w, kind, win);
+}
+
+// console output, and the items_per_second of every case for the pipeline check
+class PipelineCheck : public benchmark::ConsoleReporter {
+public:
+    void ReportRuns(const std::vector<Run> &runs) override {
+        ConsoleReporter::ReportRuns(runs);
+        for (const Run &run : runs) {
+            if (run.error_occurred || (run.run_type == Run::RT_Aggregate && run.aggregate_name != "median")) {
+                continue;
+            }
+            const auto it = run.counters.find("items_per_second");
+            if (it != run.counters.end()) {
+                double &rate = rates[run.run_name.str()];
+                rate = std::max(rate, it->second.value);
+            }
+        }
+    }
+
+    // every BM_Pipeline* case that ran against its BM_Separate* counterpart
+    bool passed() const {
+        const std::string fused = "BM_Pipeline", separate = "BM_Separate";
+        bool ok = true;
+        for (const auto &r : rates) {
+            if (r.first.compare(0, fused.size(), fused) != 0) continue;
+            const auto other = rates.find(separate + r.first.substr(fused.size()));
+            if (other == rates.end()) continue;
+            if (r.second <= other->second) {
+                std::fprintf(stderr, "%s: %.3g items/s, not faster than %s at %.3g items/s\n", r.first.c_str(),
+                             r.second, other->first.c_str(), other->second);
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+private:
+    std::map<std::string, double> rates;
+};
+
+}  // namespace
+
+#define SLIDING_WINDOW_BENCH(cls, kind) \
+    BENCHMARK_TEMPLATE(BM_##cls, kind)->RangeMultiplier(16)->Range(64, 16384)
+
+#define SLIDING_WINDOW_BENCH_ALL(cls)          \
+    SLIDING_WINDOW_BENCH(cls, Random);         \
+    SLIDING_WINDOW_BENCH(cls, Ascending);      \
+    SLIDING_WINDOW_BENCH(cls, Descending);     \
+    SLIDING_WINDOW_BENCH(cls, Constant);       \
+    SLIDING_WINDOW_BENCH(cls, Replay)
+
+SLIDING_WINDOW_BENCH_ALL(WelfordStd);
+SLIDING_WINDOW_BENCH_ALL(MonoQueue);
+SLIDING_WINDOW_BENCH_ALL(MKAverage);
+SLIDING_WINDOW_BENCH(Separate, Random);
+SLIDING_WINDOW_BENCH(Pipeline, Random);
+SLIDING_WINDOW_BENCH(SeparateTrimmed, Random);
+SLIDING_WINDOW_BENCH(PipelineTrimmed, Random);
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    PipelineCheck reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+    return reporter.passed() ? 0 : 1;
+}
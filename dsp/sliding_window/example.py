@@ -21,3 +21,30 @@ arr = np.arange(100)
 for i in range(105):
 	dsp.calcSlidingStd(i)
 	print(dsp.getCnt(), dsp.getStd(), np.std(arr[:i+1], ddof=1))
+
+# 批量接口：整段数组一次调用，状态在多次调用之间延续
+data = np.random.randn(10000)
+stream = sliding_window_dsp.WelfordStd(100)
+out = np.empty_like(data)
+stream.process(data[:5000], out=out[:5000])
+stream.process(data[5000:], out=out[5000:])
+ref = sliding_window_dsp.WelfordStd(100)
+print('batch vs per-sample max diff:', np.max(np.abs(out - np.array([ref.calcSlidingStd(v) for v in data]))))
+
+# 时间窗接口：按时间戳淘汰，适合抖动/丢包的传感器流（此处为最近 500 ms）
+ts = np.cumsum(np.random.exponential(0.01, 10000))
+tw = sliding_window_dsp.TimeWindowWelfordStd(0.5)
+tw_std = tw.process(ts, data)
+print('time window std (last 5):', tw_std[-5:], 'samples in window:', tw.getCnt())
+
+# 双流滑窗协方差/相关系数/回归斜率，一次调用得到整段结果
+acc = np.random.randn(10000)
+gyr = 0.5 * acc + 0.1 * np.random.randn(10000)
+cov, corr, slope, intercept = sliding_window_dsp.SlidingCovariance(200).process(acc, gyr)
+print('rolling corr (last):', corr[-1], 'slope:', slope[-1])
+
+# 指数加权与多速率降采样统计：1 kHz 流上得到 1 s / 10 s / 60 s 摘要，不保存原始样本
+ewma_mean, ewma_std = sliding_window_dsp.EwmaStats(0.01).process(data)
+dec = sliding_window_dsp.DecimatingStats([1000, 10, 6])
+blocks = dec.process(np.random.randn(120000))
+print('1 s / 10 s / 60 s blocks:', [b.shape[0] for b in blocks], '60 s (count, mean, std, min, max):', blocks[2][-1])
@@ -1,26 +1,447 @@
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>  // 包含这个头文件
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "DecimatingStats.h"
+#include "EwmaStats.h"
 #include "MKAverage.h"
 #include "MonoQueue.h"
+#include "MultiChannelMKAverage.h"
+#include "MultiChannelMonoQueue.h"
+#include "MultiChannelWelfordStd.h"
+#include "SlidingCovariance.h"
+#include "SlidingExtrema.h"
+#include "SlidingQuantile.h"
+#include "SlidingStats.h"
+#include "TimeWindowMKAverage.h"
+#include "TimeWindowMonoQueue.h"
+#include "TimeWindowWelfordStd.h"
 #include "WelfordStd.h"
 
 namespace py = pybind11;
 
+// 符合要求的 float64 连续数组不会被拷贝，其余输入由 numpy 转换一次
+using InputArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+// out 为 None 时按 x 的形状新分配输出；否则必须是同形状、可写、C 连续、dtype 为 T 的数组，原地写入
+template<typename T = double>
+static py::array_t<T> output_like(const InputArray &x, const py::object &out_obj) {
+    if (out_obj.is_none())
+        return py::array_t<T>(std::vector<py::ssize_t>(x.shape(), x.shape() + x.ndim()));
+
+    if (!py::isinstance<py::array_t<T>>(out_obj))
+        throw std::invalid_argument("out must be np.ndarray dtype=" + py::str(py::dtype::of<T>()).cast<std::string>());
+    auto out = out_obj.cast<py::array_t<T>>();
+    if (out.ndim() != x.ndim() || !std::equal(x.shape(), x.shape() + x.ndim(), out.shape()))
+        throw std::invalid_argument("out must have the same shape as x");
+    if (!(out.flags() & py::array::c_style))
+        throw std::invalid_argument("out must be C-contiguous");
+    if (!out.writeable())
+        throw std::invalid_argument("out must be writeable");
+    return out;
+}
+
+// 多个输出的 process：out 为 None 或长度为 k 的 tuple，拆成 k 个 out 分别交给 output_like
+static std::vector<py::object> split_out(const py::object &out_obj, size_t k) {
+    if (out_obj.is_none())
+        return std::vector<py::object>(k, py::none());
+    if (!py::isinstance<py::tuple>(out_obj) || py::len(out_obj) != k)
+        throw std::invalid_argument("out must be a tuple of " + std::to_string(k) + " arrays");
+    std::vector<py::object> outs;
+    for (const auto &o : out_obj.cast<py::tuple>())
+        outs.push_back(py::reinterpret_borrow<py::object>(o));
+    return outs;
+}
+
+// 在释放 GIL 的情况下对整段一维数组逐点运行 kernel(x, n, out)
+template<typename Kernel>
+static py::array_t<double> process_array(const InputArray &x, const py::object &out_obj, Kernel &&kernel) {
+    if (x.ndim() != 1)
+        throw std::invalid_argument("expected 1D array");
+    auto out = output_like(x, out_obj);
+    const double *px = x.data();
+    double *pout = out.mutable_data();
+    {
+        py::gil_scoped_release release;
+        kernel(px, (size_t) x.shape(0), pout);
+    }
+    return out;
+}
+
+// (T, C) 版本：x 的每一行是一个时间戳的 C 个通道，输出同形状
+template<typename Kernel>
+static py::array_t<double> process_rows(const InputArray &x, int channels, const py::object &out_obj, Kernel &&kernel) {
+    if (x.ndim() != 2 || x.shape(1) != channels)
+        throw std::invalid_argument("expected 2D array of shape (T, channels)");
+    auto out = output_like(x, out_obj);
+    const double *px = x.data();
+    double *pout = out.mutable_data();
+    {
+        py::gil_scoped_release release;
+        kernel(px, (size_t) x.shape(0), pout);
+    }
+    return out;
+}
+
+// 时间窗版本：t 与 x 为等长一维数组，t 必须单调不减（与 duration 同单位）
+template<typename Kernel>
+static py::array_t<double> process_timed(const InputArray &t, const InputArray &x, const py::object &out_obj, Kernel &&kernel) {
+    if (t.ndim() != 1 || x.ndim() != 1 || t.shape(0) != x.shape(0))
+        throw std::invalid_argument("expected 1D timestamps and values of equal length");
+    auto out = output_like(x, out_obj);
+    const double *pt = t.data();
+    const double *px = x.data();
+    double *pout = out.mutable_data();
+    {
+        py::gil_scoped_release release;
+        kernel(pt, px, (size_t) x.shape(0), pout);
+    }
+    return out;
+}
+
+// 单个时间戳的一行通道值
+template<typename Push>
+static py::array_t<double> push_row(const InputArray &row, int channels, Push &&push) {
+    if (row.ndim() != 1 || row.shape(0) != channels)
+        throw std::invalid_argument("expected 1D array of length channels");
+    const double *res = push(row.data());
+    return py::array_t<double>(channels, res);
+}
+
+template<typename Multi>
+static void bind_multi_channel(py::class_<Multi> &cls) {
+    cls.def("push",
+            [](Multi &self, const InputArray &row) {
+                return push_row(row, self.getChannels(), [&self](const double *p) { return self.push(p); });
+            },
+            py::arg("row"))
+        .def("getChannels", &Multi::getChannels)
+        .def("process",
+             [](Multi &self, const InputArray &x, const py::object &out) {
+                 return process_rows(x, self.getChannels(), out, [&self](const double *px, size_t T, double *pout) {
+                     self.process(px, T, pout);
+                 });
+             },
+             py::arg("x"), py::arg("out") = py::none(),
+             "process a (T, channels) array, continuing from the current state");
+}
+
+template<typename Quantile>
+static void bind_quantile(py::class_<Quantile> &cls) {
+    cls.def("push", &Quantile::push)
+        .def("value", &Quantile::value)
+        .def("median", &Quantile::median)
+        .def("quantile", &Quantile::quantile, py::arg("p"))
+        .def("getCnt", &Quantile::getCnt)
+        .def("clear", &Quantile::clear)
+        .def("process",
+             [](Quantile &self, const InputArray &x, const py::object &out) {
+                 return process_array(x, out, [&self](const double *px, size_t n, double *pout) {
+                     self.process(px, n, pout);
+                 });
+             },
+             py::arg("x"), py::arg("out") = py::none(),
+             "push + value over a whole array, continuing from the current state");
+}
+
+template<typename Stats>
+static void bind_sliding_stats(py::module &m, const char *name) {
+    py::class_<Stats>(m, name)
+        .def(py::init<int>(), py::arg("win"))
+        .def("push", &Stats::push)
+        .def("count", &Stats::count)
+        .def("mean", &Stats::mean)
+        .def("variance", &Stats::variance)
+        .def("getStd", &Stats::getStd)
+        .def("min", &Stats::min)
+        .def("max", &Stats::max)
+        .def("clear", &Stats::clear)
+        .def("process",
+             [](Stats &self, const InputArray &x, const py::object &out) {
+                 return process_array(x, out, [&self](const double *px, size_t n, double *pout) {
+                     self.process(px, n, pout);
+                 });
+             },
+             py::arg("x"), py::arg("out") = py::none(),
+             "push over a whole array and return the sliding std after each sample");
+}
+
+// 检查点：serialize() 得到 bytes，deserialize(bytes) 恢复，同时支持 pickle，
+// 服务重启或跨进程交接时无需重新预热窗口
+template<typename Window>
+static void bind_state(py::class_<Window> &cls) {
+    cls.def("serialize", [](const Window &self) { return py::bytes(self.serialize()); },
+            "full internal state as bytes")
+        .def_static("deserialize", [](const py::bytes &state) { return Window::deserialize(state); },
+                    py::arg("state"), "restore an object from serialize() output")
+        .def(py::pickle(
+            [](const Window &self) { return py::bytes(self.serialize()); },
+            [](const py::bytes &state) { return Window::deserialize(state); }));
+}
+
 PYBIND11_MODULE(sliding_window_dsp, m) {
-    py::class_<MKAverage>(m, "MKAverage")
-        .def(py::init<int, int>())
+    py::class_<MKAverage> mka(m, "MKAverage");
+    mka.def(py::init<int, int>())
         .def("addElement", &MKAverage::addElement)
-        .def("calculateMKAverage", &MKAverage::calculateMKAverage);
+        .def("calculateMKAverage", &MKAverage::calculateMKAverage)
+        .def("process",
+             [](MKAverage &self, const InputArray &x, const py::object &out) {
+                 return process_array(x, out, [&self](const double *px, size_t n, double *pout) {
+                     self.process(px, n, pout);
+                 });
+             },
+             py::arg("x"), py::arg("out") = py::none(),
+             "addElement + calculateMKAverage over a whole array, continuing from the current state");
+    bind_state(mka);
 
-    py::class_<MonoQueue>(m, "MonoQueue")
-        .def(py::init<int>())
+    py::class_<MonoQueue> mq(m, "MonoQueue");
+    mq.def(py::init<int>())
         .def("push", &MonoQueue::push)
-        .def("max", &MonoQueue::max);
+        .def("max", &MonoQueue::max)
+        .def("process",
+             [](MonoQueue &self, const InputArray &x, const py::object &out) {
+                 return process_array(x, out, [&self](const double *px, size_t n, double *pout) {
+                     self.process(px, n, pout);
+                 });
+             },
+             py::arg("x"), py::arg("out") = py::none(),
+             "push + max over a whole array, continuing from the current state");
+    bind_state(mq);
 
-    py::class_<WelfordStd>(m, "WelfordStd")
-        .def(py::init<int>())
+    py::class_<WelfordStd> ws(m, "WelfordStd");
+    ws.def(py::init<int>())
         .def("calcSlidingStd", &WelfordStd::calcSlidingStd)
         .def("getStd", &WelfordStd::getStd)
-        .def("getCnt", &WelfordStd::getCnt);
+        .def("getCnt", &WelfordStd::getCnt)
+        .def("process",
+             [](WelfordStd &self, const InputArray &x, const py::object &out) {
+                 return process_array(x, out, [&self](const double *px, size_t n, double *pout) {
+                     self.process(px, n, pout);
+                 });
+             },
+             py::arg("x"), py::arg("out") = py::none(),
+             "calcSlidingStd over a whole array, continuing from the current state");
+    bind_state(ws);
+
+    py::class_<EwmaStats> ew(m, "EwmaStats");
+    ew.def(py::init<double>(), py::arg("alpha"))
+        .def_static("alphaFromHalfLife", &EwmaStats::alphaFromHalfLife, py::arg("half_life"))
+        .def("update", &EwmaStats::update)
+        .def("getMean", &EwmaStats::getMean)
+        .def("getVar", &EwmaStats::getVar)
+        .def("getStd", &EwmaStats::getStd)
+        .def("getAlpha", &EwmaStats::getAlpha)
+        .def("getCnt", &EwmaStats::getCnt)
+        .def("clear", &EwmaStats::clear)
+        .def("process",
+             [](EwmaStats &self, const InputArray &x, const py::object &out) {
+                 if (x.ndim() != 1)
+                     throw std::invalid_argument("expected 1D array");
+                 const auto n = (py::ssize_t) x.shape(0);
+                 const auto outs = split_out(out, 2);
+                 auto mean = output_like(x, outs[0]), sd = output_like(x, outs[1]);
+                 const double *px = x.data();
+                 double *pmean = mean.mutable_data(), *pstd = sd.mutable_data();
+                 {
+                     py::gil_scoped_release release;
+                     self.process(px, (size_t) n, pmean, pstd);
+                 }
+                 return py::make_tuple(mean, sd);
+             },
+             py::arg("x"), py::arg("out") = py::none(),
+             "update over a whole array, return (mean, std) after each sample; "
+             "out=(mean, std) writes into existing arrays");
+    bind_state(ew);
+
+    // 每个 block 以 (count, mean, std, min, max) 表示
+    auto block_tuple = [](const DecimatingStats::Block &b) {
+        return py::make_tuple(b.count, b.mean, b.std(), b.min, b.max);
+    };
+    py::class_<DecimatingStats> dec(m, "DecimatingStats");
+    dec.def(py::init<const std::vector<int> &>(), py::arg("factors"))
+        .def("push", &DecimatingStats::push)
+        .def("getLevels", &DecimatingStats::getLevels)
+        .def("getFactor", &DecimatingStats::getFactor, py::arg("level"))
+        .def("getCnt", &DecimatingStats::getCnt, py::arg("level"))
+        .def("latest", [block_tuple](const DecimatingStats &self, int level) {
+            return block_tuple(self.latest(level));
+        }, py::arg("level"), "last completed block of a level as (count, mean, std, min, max)")
+        .def("clear", &DecimatingStats::clear)
+        .def("process",
+             [](DecimatingStats &self, const InputArray &x) {
+                 if (x.ndim() != 1)
+                     throw std::invalid_argument("expected 1D array");
+                 std::vector<std::vector<DecimatingStats::Block>> emitted(self.getLevels());
+                 const double *px = x.data();
+                 {
+                     py::gil_scoped_release release;
+                     self.process(px, (size_t) x.shape(0), emitted.data());
+                 }
+                 py::list res;
+                 for (const auto &blocks : emitted) {
+                     py::array_t<double> arr(std::vector<py::ssize_t>{(py::ssize_t) blocks.size(), 5});
+                     double *p = arr.mutable_data();
+                     for (const auto &b : blocks) {
+                         *p++ = (double) b.count;
+                         *p++ = b.mean;
+                         *p++ = b.std();
+                         *p++ = b.min;
+                         *p++ = b.max;
+                     }
+                     res.append(arr);
+                 }
+                 return res;
+             },
+             py::arg("x"),
+             "push a whole array, return one (k, 5) array per level with the blocks completed "
+             "during the call as rows of (count, mean, std, min, max)");
+    bind_state(dec);
+
+    bind_sliding_stats<SlidingStats<double, false>>(m, "SlidingStats");
+    bind_sliding_stats<SlidingStats<double, true>>(m, "CompensatedSlidingStats");
+
+    py::class_<MultiChannelWelfordStd> mcw(m, "MultiChannelWelfordStd");
+    mcw.def(py::init<int, int>(), py::arg("win"), py::arg("channels"))
+        .def("getStd", [](const MultiChannelWelfordStd &self) {
+            return py::array_t<double>(self.getChannels(), self.getStd());
+        })
+        .def("getCnt", &MultiChannelWelfordStd::getCnt);
+    bind_multi_channel(mcw);
+
+    py::class_<MultiChannelMonoQueue> mcq(m, "MultiChannelMonoQueue");
+    mcq.def(py::init<int, int>(), py::arg("win"), py::arg("channels"))
+        .def("max", [](const MultiChannelMonoQueue &self) {
+            return py::array_t<double>(self.getChannels(), self.max());
+        });
+    bind_multi_channel(mcq);
+
+    py::class_<MultiChannelMKAverage> mck(m, "MultiChannelMKAverage");
+    mck.def(py::init<int, int, int>(), py::arg("m"), py::arg("k"), py::arg("channels"))
+        .def("calculateMKAverage", [](const MultiChannelMKAverage &self) {
+            return py::array_t<double>(self.getChannels(), self.calculateMKAverage());
+        });
+    bind_multi_channel(mck);
+
+    py::class_<SlidingExtrema>(m, "SlidingExtrema")
+        .def(py::init<int>(), py::arg("win"))
+        .def("push", &SlidingExtrema::push)
+        .def("min", &SlidingExtrema::min)
+        .def("max", &SlidingExtrema::max)
+        .def("argmin", &SlidingExtrema::argmin)
+        .def("argmax", &SlidingExtrema::argmax)
+        .def("range", &SlidingExtrema::range)
+        .def("getCnt", &SlidingExtrema::getCnt)
+        .def("clear", &SlidingExtrema::clear)
+        .def("process",
+             [](SlidingExtrema &self, const InputArray &x, const py::object &out) {
+                 if (x.ndim() != 1)
+                     throw std::invalid_argument("expected 1D array");
+                 const auto n = (py::ssize_t) x.shape(0);
+                 const auto outs = split_out(out, 4);
+                 auto mn = output_like(x, outs[0]), mx = output_like(x, outs[1]);
+                 auto amn = output_like<int64_t>(x, outs[2]), amx = output_like<int64_t>(x, outs[3]);
+                 const double *px = x.data();
+                 double *pmn = mn.mutable_data(), *pmx = mx.mutable_data();
+                 int64_t *pamn = amn.mutable_data(), *pamx = amx.mutable_data();
+                 {
+                     py::gil_scoped_release release;
+                     self.process(px, (size_t) n, pmn, pmx, pamn, pamx);
+                 }
+                 return py::make_tuple(mn, mx, amn, amx);
+             },
+             py::arg("x"), py::arg("out") = py::none(),
+             "push a whole array, return (min, max, argmin, argmax) after each sample; "
+             "out=(min, max, argmin, argmax) writes into existing arrays (argmin/argmax int64)");
+
+    py::class_<SlidingCovariance>(m, "SlidingCovariance")
+        .def(py::init<int>(), py::arg("win"))
+        .def("push", &SlidingCovariance::push, py::arg("x"), py::arg("y"))
+        .def("getCov", &SlidingCovariance::getCov)
+        .def("getCorr", &SlidingCovariance::getCorr)
+        .def("getSlope", &SlidingCovariance::getSlope)
+        .def("getIntercept", &SlidingCovariance::getIntercept)
+        .def("getMeanX", &SlidingCovariance::getMeanX)
+        .def("getMeanY", &SlidingCovariance::getMeanY)
+        .def("getStdX", &SlidingCovariance::getStdX)
+        .def("getStdY", &SlidingCovariance::getStdY)
+        .def("getCnt", &SlidingCovariance::getCnt)
+        .def("clear", &SlidingCovariance::clear)
+        .def("process",
+             [](SlidingCovariance &self, const InputArray &x, const InputArray &y, const py::object &out) {
+                 if (x.ndim() != 1 || y.ndim() != 1 || x.shape(0) != y.shape(0))
+                     throw std::invalid_argument("expected two 1D arrays of equal length");
+                 const auto n = (py::ssize_t) x.shape(0);
+                 const auto outs = split_out(out, 4);
+                 auto cov = output_like(x, outs[0]), corr = output_like(x, outs[1]);
+                 auto slope = output_like(x, outs[2]), intercept = output_like(x, outs[3]);
+                 const double *px = x.data(), *py_ = y.data();
+                 double *pcov = cov.mutable_data(), *pcorr = corr.mutable_data();
+                 double *pslope = slope.mutable_data(), *pintercept = intercept.mutable_data();
+                 {
+                     py::gil_scoped_release release;
+                     self.process(px, py_, (size_t) n, pcov, pcorr, pslope, pintercept);
+                 }
+                 return py::make_tuple(cov, corr, slope, intercept);
+             },
+             py::arg("x"), py::arg("y"), py::arg("out") = py::none(),
+             "push two arrays, return (cov, corr, slope, intercept) after each pair; "
+             "out=(cov, corr, slope, intercept) writes into existing arrays");
+
+    py::class_<SlidingQuantile> sq(m, "SlidingQuantile");
+    sq.def(py::init<int, double>(), py::arg("m"), py::arg("q") = 0.5);
+    bind_quantile(sq);
+
+    py::class_<ApproxSlidingQuantile> asq(m, "ApproxSlidingQuantile");
+    asq.def(py::init<int, double, int, int>(),
+            py::arg("m"), py::arg("q") = 0.5, py::arg("blocks") = 64, py::arg("resolution") = 256);
+    bind_quantile(asq);
+
+    py::class_<TimeWindowWelfordStd>(m, "TimeWindowWelfordStd")
+        .def(py::init<double, int>(), py::arg("duration"), py::arg("capacity_hint") = 64)
+        .def("push", &TimeWindowWelfordStd::push, py::arg("t"), py::arg("x"))
+        .def("advance", &TimeWindowWelfordStd::advance, py::arg("t"))
+        .def("getStd", &TimeWindowWelfordStd::getStd)
+        .def("getMean", &TimeWindowWelfordStd::getMean)
+        .def("getCnt", &TimeWindowWelfordStd::getCnt)
+        .def("process",
+             [](TimeWindowWelfordStd &self, const InputArray &t, const InputArray &x, const py::object &out) {
+                 return process_timed(t, x, out, [&self](const double *pt, const double *px, size_t n, double *pout) {
+                     self.process(pt, px, n, pout);
+                 });
+             },
+             py::arg("t"), py::arg("x"), py::arg("out") = py::none(),
+             "push (timestamp, value) arrays, return the std of the window (t - duration, t] after each sample");
+
+    py::class_<TimeWindowMonoQueue>(m, "TimeWindowMonoQueue")
+        .def(py::init<double, int>(), py::arg("duration"), py::arg("capacity_hint") = 64)
+        .def("push", &TimeWindowMonoQueue::push, py::arg("t"), py::arg("val"))
+        .def("advance", &TimeWindowMonoQueue::advance, py::arg("t"))
+        .def("max", &TimeWindowMonoQueue::max)
+        .def("empty", &TimeWindowMonoQueue::empty)
+        .def("process",
+             [](TimeWindowMonoQueue &self, const InputArray &t, const InputArray &x, const py::object &out) {
+                 return process_timed(t, x, out, [&self](const double *pt, const double *px, size_t n, double *pout) {
+                     self.process(pt, px, n, pout);
+                 });
+             },
+             py::arg("t"), py::arg("x"), py::arg("out") = py::none(),
+             "push (timestamp, value) arrays, return the max of the window (t - duration, t] after each sample");
+
+    py::class_<TimeWindowMKAverage>(m, "TimeWindowMKAverage")
+        .def(py::init<double, int, int>(), py::arg("duration"), py::arg("k"), py::arg("capacity_hint") = 64)
+        .def("addElement", &TimeWindowMKAverage::addElement, py::arg("t"), py::arg("num"))
+        .def("advance", &TimeWindowMKAverage::advance, py::arg("t"))
+        .def("calculateMKAverage", &TimeWindowMKAverage::calculateMKAverage)
+        .def("getCnt", &TimeWindowMKAverage::getCnt)
+        .def("process",
+             [](TimeWindowMKAverage &self, const InputArray &t, const InputArray &x, const py::object &out) {
+                 return process_timed(t, x, out, [&self](const double *pt, const double *px, size_t n, double *pout) {
+                     self.process(pt, px, n, pout);
+                 });
+             },
+             py::arg("t"), py::arg("x"), py::arg("out") = py::none(),
+             "push (timestamp, value) arrays, return the MKAverage of the window (t - duration, t] after each sample");
 }
@@ -0,0 +1,57 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_ACCUMULATOR_H
+#define FFALCONXR_ACCUMULATOR_H
+
+#include <cmath>
+
+// Running sum. The compensated flavour uses Neumaier's variant of Kahan summation,
+// which keeps the rounding error of every add() in a separate term.
+// Under -ffast-math the compiler is free to reassociate (sum - t) + x into zero, so
+// the intermediate terms are forced through memory there to keep the compensation alive.
+template<typename T, bool Compensated>
+class Accumulator;
+
+template<typename T>
+class Accumulator<T, false> {
+public:
+    void add(T x) { sum += x; }
+
+    T value() const { return sum; }
+
+    void clear() { sum = 0; }
+
+private:
+    T sum = 0;
+};
+
+template<typename T>
+class Accumulator<T, true> {
+public:
+    void add(T x) {
+        const bool big = std::abs(sum) >= std::abs(x);
+#ifdef __FAST_MATH__
+        volatile T rounded = sum + x;
+        const T t = rounded;
+        volatile T lost = big ? sum - t : x - t;
+        comp += lost + (big ? x : sum);
+#else
+        const T t = sum + x;
+        comp += big ? (sum - t) + x : (x - t) + sum;
+#endif
+        sum = t;
+    }
+
+    T value() const { return sum + comp; }
+
+    void clear() { sum = comp = 0; }
+
+private:
+    T sum = 0;
+    T comp = 0;
+};
+
+
+#endif //FFALCONXR_ACCUMULATOR_H
@@ -0,0 +1,275 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#include "BlockedSortedList.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// branch-free binary search over the block maxima: on random data
+// std::lower_bound mispredicts about half of its steps
+int lowerIndex(const double *a, int n, double value) {
+    if (n == 0) {
+        return 0;
+    }
+    const double *base = a;
+    while (n > 1) {
+        const int half = n / 2;
+        base = base[half - 1] < value ? base + half : base;
+        n -= half;
+    }
+    return (int) (base - a) + (*base < value);
+}
+
+// position inside a block by counting, which vectorizes; the memmove right
+// after reads the whole block anyway, a binary search would wait on each load
+int lowerCount(const double *b, int n, double value) {
+    int j = 0;
+    for (int i = 0; i < n; ++i) j += b[i] < value;
+    return j;
+}
+
+int upperCount(const double *b, int n, double value) {
+    int j = 0;
+    for (int i = 0; i < n; ++i) j += b[i] <= value;
+    return j;
+}
+
+}
+
+BlockedSortedList::BlockedSortedList(int capacity) : cap(capacity), blockCap(64) {
+    if (capacity <= 0) {
+        throw std::invalid_argument("BlockedSortedList: capacity must be positive");
+    }
+    // about 2 * sqrt(capacity) per block balances block search against memmove length
+    while (blockCap < 1024 && (long long) blockCap * blockCap < 4LL * capacity) {
+        blockCap *= 2;
+    }
+    // adjacent blocks always hold more than blockCap / 2 values together
+    const int maxBlocks = 4 * (capacity / blockCap) + 3;
+    pool = std::vector<double>((size_t) maxBlocks * blockCap);
+    ids = std::vector<int>(maxBlocks);
+    counts = std::vector<int>(maxBlocks);
+    maxes = std::vector<double>(maxBlocks);
+    freeIds.reserve(maxBlocks);
+    clear();
+}
+
+int BlockedSortedList::insert(double value) {
+    if (count >= cap) {
+        throw std::length_error("BlockedSortedList: capacity exceeded");
+    }
+    int pos = lowerBlock(value);
+    if (pos == nBlocks) {
+        pos = nBlocks - 1;
+    }
+    double *b = block(ids[pos]);
+    const int n = counts[pos];
+    const int j = upperCount(b, n, value);
+    std::memmove(b + j + 1, b + j, sizeof(double) * (n - j));
+    b[j] = value;
+    counts[pos] = n + 1;
+    if (j == n) {
+        maxes[pos] = value;
+    }
+    count++;
+    const int rank = countBefore(pos) + j;
+
+    if (counts[pos] == blockCap) {
+        // split the full block in halves
+        const int half = blockCap / 2;
+        const int id = freeIds.back();
+        freeIds.pop_back();
+        std::memcpy(block(id), b + half, sizeof(double) * (blockCap - half));
+        insertBlock(pos + 1, id);
+        counts[pos + 1] = blockCap - half;
+        maxes[pos + 1] = maxes[pos];
+        counts[pos] = half;
+        maxes[pos] = b[half - 1];
+    }
+    return rank;
+}
+
+int BlockedSortedList::erase(double value) {
+    const int pos = lowerBlock(value);
+    if (pos == nBlocks) {
+        return -1;
+    }
+    double *b = block(ids[pos]);
+    const int n = counts[pos];
+    const int j = lowerCount(b, n, value);
+    if (j == n || b[j] != value) {
+        return -1;
+    }
+    const int rank = countBefore(pos) + j;
+    std::memmove(b + j, b + j + 1, sizeof(double) * (n - j - 1));
+    counts[pos] = n - 1;
+    if (j == n - 1 && n > 1) {
+        maxes[pos] = b[n - 2];
+    }
+    count--;
+
+    if (nBlocks > 1) {
+        const int half = blockCap / 2;
+        if (counts[pos] == 0) {
+            removeBlock(pos);
+        } else if (pos + 1 < nBlocks && counts[pos] + counts[pos + 1] <= half) {
+            std::memcpy(b + counts[pos], block(ids[pos + 1]), sizeof(double) * counts[pos + 1]);
+            counts[pos] += counts[pos + 1];
+            maxes[pos] = maxes[pos + 1];
+            removeBlock(pos + 1);
+        } else if (pos > 0 && counts[pos - 1] + counts[pos] <= half) {
+            std::memcpy(block(ids[pos - 1]) + counts[pos - 1], b, sizeof(double) * counts[pos]);
+            counts[pos - 1] += counts[pos];
+            maxes[pos - 1] = maxes[pos];
+            removeBlock(pos);
+        }
+    }
+    return rank;
+}
+
+double BlockedSortedList::at(int rank) const {
+    int offset;
+    const int pos = locate(rank, offset);
+    return block(ids[pos])[offset];
+}
+
+double BlockedSortedList::sum(int first, int last) const {
+    double s = 0.0;
+    if (first >= last) {
+        return s;
+    }
+    int offset;
+    int pos = locate(first, offset);
+    int remaining = last - first;
+    while (remaining > 0) {
+        const double *b = block(ids[pos]);
+        const int take = std::min(counts[pos] - offset, remaining);
+        for (int i = 0; i < take; ++i) {
+            s += b[offset + i];
+        }
+        remaining -= take;
+        offset = 0;
+        pos++;
+    }
+    return s;
+}
+
+double BlockedSortedList::quantile(double p) const {
+    if (count == 0) {
+        return 0.0;
+    }
+    const double h = (count - 1) * std::min(std::max(p, 0.0), 1.0);
+    const int lo = (int) h;
+    if (lo + 1 >= count) {
+        return at(count - 1);
+    }
+    int offset;
+    int pos = locate(lo, offset);
+    const double a = block(ids[pos])[offset];
+    if (++offset == counts[pos]) {
+        offset = 0;
+        pos++;
+    }
+    const double b = block(ids[pos])[offset];
+    return a + (h - lo) * (b - a);
+}
+
+int BlockedSortedList::size() const {
+    return count;
+}
+
+int BlockedSortedList::capacity() const {
+    return cap;
+}
+
+void BlockedSortedList::clear() {
+    count = 0;
+    freeIds.clear();
+    for (int i = (int) ids.size() - 1; i > 0; --i) {
+        freeIds.push_back(i);
+    }
+    // keep one (possibly empty) block so inserts always have a target
+    nBlocks = 1;
+    ids[0] = 0;
+    counts[0] = 0;
+    maxes[0] = 0.0;
+}
+
+void BlockedSortedList::grow() {
+    cap *= 2;
+    const int oldBlocks = (int) ids.size();
+    const int maxBlocks = 4 * (cap / blockCap) + 3;
+    pool.resize((size_t) maxBlocks * blockCap);
+    ids.resize(maxBlocks);
+    counts.resize(maxBlocks);
+    maxes.resize(maxBlocks);
+    freeIds.reserve(maxBlocks);
+    for (int i = maxBlocks - 1; i >= oldBlocks; --i) {
+        freeIds.push_back(i);
+    }
+}
+
+double *BlockedSortedList::block(int id) {
+    return pool.data() + (size_t) id * blockCap;
+}
+
+const double *BlockedSortedList::block(int id) const {
+    return pool.data() + (size_t) id * blockCap;
+}
+
+int BlockedSortedList::lowerBlock(double value) const {
+    if (count == 0) {
+        return 0;
+    }
+    return lowerIndex(maxes.data(), nBlocks, value);
+}
+
+int BlockedSortedList::countBefore(int pos) const {
+    int s = 0;
+    if (pos <= nBlocks / 2) {
+        for (int i = 0; i < pos; ++i) s += counts[i];
+        return s;
+    }
+    for (int i = pos; i < nBlocks; ++i) s += counts[i];
+    return count - s;
+}
+
+int BlockedSortedList::locate(int rank, int &offset) const {
+    if (rank < count / 2) {
+        int pos = 0;
+        while (rank >= counts[pos]) {
+            rank -= counts[pos++];
+        }
+        offset = rank;
+        return pos;
+    }
+    int pos = nBlocks - 1;
+    int back = count - 1 - rank;
+    while (back >= counts[pos]) {
+        back -= counts[pos--];
+    }
+    offset = counts[pos] - 1 - back;
+    return pos;
+}
+
+void BlockedSortedList::insertBlock(int pos, int id) {
+    const int tail = nBlocks - pos;
+    std::memmove(ids.data() + pos + 1, ids.data() + pos, sizeof(int) * tail);
+    std::memmove(counts.data() + pos + 1, counts.data() + pos, sizeof(int) * tail);
+    std::memmove(maxes.data() + pos + 1, maxes.data() + pos, sizeof(double) * tail);
+    ids[pos] = id;
+    nBlocks++;
+}
+
+void BlockedSortedList::removeBlock(int pos) {
+    freeIds.push_back(ids[pos]);
+    const int tail = nBlocks - pos - 1;
+    std::memmove(ids.data() + pos, ids.data() + pos + 1, sizeof(int) * tail);
+    std::memmove(counts.data() + pos, counts.data() + pos + 1, sizeof(int) * tail);
+    std::memmove(maxes.data() + pos, maxes.data() + pos + 1, sizeof(double) * tail);
+    nBlocks--;
+}
@@ -0,0 +1,64 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_BLOCKEDSORTEDLIST_H
+#define FFALCONXR_BLOCKEDSORTEDLIST_H
+
+#include <vector>
+
+// Sorted multiset of doubles with rank queries, stored as a list of sorted blocks.
+// Blocks come from a pool sized in the constructor, so a window of up to
+// `capacity` values is maintained without heap traffic. Lookups binary-search
+// the contiguous block maxima and then the block itself; updates are a memmove
+// inside one block, which keeps everything in a few cache lines.
+class BlockedSortedList {
+public:
+    explicit BlockedSortedList(int capacity);
+
+    // insert value after any equal values, return its 0-based rank.
+    int insert(double value);
+
+    // remove one copy of value, return the 0-based rank it had, or -1 if absent.
+    int erase(double value);
+
+    // value of the rank-th smallest element.
+    double at(int rank) const;
+
+    // sum of the elements with rank in [first, last).
+    double sum(int first, int last) const;
+
+    // p-quantile (0 <= p <= 1) with linear interpolation between ranks, like np.quantile.
+    double quantile(double p) const;
+
+    int size() const;
+    int capacity() const;
+    void clear();
+
+    // double the capacity, keeping the contents; only for windows without a fixed size.
+    void grow();
+
+private:
+    double *block(int id);
+    const double *block(int id) const;
+    int lowerBlock(double value) const;
+    int countBefore(int pos) const;
+    int locate(int rank, int &offset) const;
+    void insertBlock(int pos, int id);
+    void removeBlock(int pos);
+
+    int cap;
+    int blockCap;
+    int nBlocks = 0;
+    int count = 0;
+
+    std::vector<double> pool;
+    // indexed by sorted position of the block
+    std::vector<int> ids;
+    std::vector<int> counts;
+    std::vector<double> maxes;
+    std::vector<int> freeIds;
+};
+
+
+#endif //FFALCONXR_BLOCKEDSORTEDLIST_H
@@ -0,0 +1,157 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#include "DecimatingStats.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "StateIO.h"
+
+void DecimatingStats::Block::add(double x) {
+    if (count == 0) {
+        min = max = x;
+    } else {
+        min = std::min(min, x);
+        max = std::max(max, x);
+    }
+    count++;
+    const double d = x - mean;
+    mean += d / (double) count;
+    m2 += d * (x - mean);
+}
+
+void DecimatingStats::Block::merge(const Block &other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    const double n = (double) (count + other.count);
+    const double d = other.mean - mean;
+    mean += d * (double) other.count / n;
+    m2 += other.m2 + d * d * (double) count * (double) other.count / n;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    count += other.count;
+}
+
+double DecimatingStats::Block::std() const {
+    return count <= 1 ? 0.0 : std::sqrt(std::max(m2, 0.0) / (double) (count - 1));
+}
+
+DecimatingStats::DecimatingStats(const std::vector<int> &factors) {
+    if (factors.empty()) {
+        throw std::invalid_argument("DecimatingStats: need at least one level");
+    }
+    for (int f : factors) {
+        if (f <= 0) {
+            throw std::invalid_argument("DecimatingStats: factors must be positive");
+        }
+        Level level;
+        level.factor = f;
+        levels.push_back(level);
+    }
+}
+
+int DecimatingStats::push(double x) {
+    Level &first = levels[0];
+    first.running.add(x);
+    if (++first.filled < first.factor) {
+        return 0;
+    }
+    // carry the completed block up the cascade
+    int completed = 0;
+    for (size_t j = 0;; ++j) {
+        Level &level = levels[j];
+        level.last = level.running;
+        level.running = Block();
+        level.filled = 0;
+        level.emitted++;
+        completed++;
+        if (j + 1 == levels.size()) {
+            break;
+        }
+        Level &next = levels[j + 1];
+        next.running.merge(level.last);
+        if (++next.filled < next.factor) {
+            break;
+        }
+    }
+    return completed;
+}
+
+int DecimatingStats::getLevels() const {
+    return (int) levels.size();
+}
+
+int DecimatingStats::getFactor(int level) const {
+    return levels.at(level).factor;
+}
+
+const DecimatingStats::Block &DecimatingStats::latest(int level) const {
+    return levels.at(level).last;
+}
+
+int64_t DecimatingStats::getCnt(int level) const {
+    return levels.at(level).emitted;
+}
+
+void DecimatingStats::clear() {
+    for (Level &level : levels) {
+        level.filled = 0;
+        level.emitted = 0;
+        level.running = Block();
+        level.last = Block();
+    }
+}
+
+void DecimatingStats::process(const double *x, size_t n, std::vector<Block> *emitted) {
+    for (size_t i = 0; i < n; ++i) {
+        const int completed = push(x[i]);
+        for (int j = 0; j < completed; ++j) {
+            emitted[j].push_back(levels[j].last);
+        }
+    }
+}
+
+std::string DecimatingStats::serialize() const {
+    StateWriter w("DECS", 1);
+    w.put<uint32_t>((uint32_t) levels.size());
+    for (const Level &level : levels) {
+        w.put<int32_t>(level.factor);
+        w.put<int32_t>(level.filled);
+        w.put(level.emitted);
+        w.put(level.running);
+        w.put(level.last);
+    }
+    return w.str();
+}
+
+DecimatingStats DecimatingStats::deserialize(const std::string &state) {
+    StateReader r(state, "DECS", 1);
+    const uint32_t n = r.get<uint32_t>();
+    // each level is factor, filled, emitted and two blocks; a corrupt count must not drive the allocation
+    const size_t levelBytes = 2 * sizeof(int32_t) + sizeof(int64_t) + 2 * sizeof(Block);
+    if (n == 0 || r.remaining() != (size_t) n * levelBytes) {
+        throw std::invalid_argument("corrupt DecimatingStats state");
+    }
+    std::vector<Level> levels(n);
+    std::vector<int> factors(n);
+    for (uint32_t j = 0; j < n; ++j) {
+        factors[j] = levels[j].factor = r.get<int32_t>();
+        levels[j].filled = r.get<int32_t>();
+        levels[j].emitted = r.get<int64_t>();
+        levels[j].running = r.get<Block>();
+        levels[j].last = r.get<Block>();
+        if (levels[j].filled < 0 || levels[j].filled >= std::max(levels[j].factor, 1)) {
+            throw std::invalid_argument("corrupt DecimatingStats state");
+        }
+    }
+    r.finish();
+    DecimatingStats res(factors);
+    res.levels = levels;
+    return res;
+}
@@ -0,0 +1,71 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_DECIMATINGSTATS_H
+#define FFALCONXR_DECIMATINGSTATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Cascaded block statistics for multi-rate summaries of one stream.
+// Level 0 summarises every factors[0] raw samples into one block, level j
+// every factors[j] blocks of level j - 1. For a 1 kHz stream, factors
+// {1000, 10, 6} gives 1 s, 10 s and 60 s count/mean/std/min/max.
+// Blocks are combined with Chan's parallel update, so each level keeps only
+// its running block and the last completed one, never the samples.
+class DecimatingStats {
+public:
+    struct Block {
+        int64_t count = 0;
+        double mean = 0.0;
+        // sum of squared deviations from mean
+        double m2 = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+
+        void add(double x);
+        void merge(const Block &other);
+        // sample std (ddof = 1), 0 for fewer than two samples
+        double std() const;
+    };
+
+    explicit DecimatingStats(const std::vector<int> &factors);
+
+    // add one sample, return how many levels completed a block with it:
+    // 0 for none, r for levels 0 .. r - 1
+    int push(double x);
+
+    int getLevels() const;
+    int getFactor(int level) const;
+    // last completed block of a level, all zero before the first one
+    const Block &latest(int level) const;
+    // completed blocks of a level so far
+    int64_t getCnt(int level) const;
+    void clear();
+
+    // push n samples, appending every block completed at level j to emitted[j];
+    // emitted must point to getLevels() vectors
+    void process(const double *x, size_t n, std::vector<Block> *emitted);
+
+    // full state as a flat binary blob, see StateIO.h
+    std::string serialize() const;
+    static DecimatingStats deserialize(const std::string &state);
+
+private:
+    struct Level {
+        int factor;
+        // children merged into the running block so far
+        int filled = 0;
+        int64_t emitted = 0;
+        Block running;
+        Block last;
+    };
+
+    std::vector<Level> levels;
+};
+
+
+#endif //FFALCONXR_DECIMATINGSTATS_H
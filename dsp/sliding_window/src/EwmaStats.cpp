@@ -0,0 +1,85 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#include "EwmaStats.h"
+#include <cmath>
+#include <stdexcept>
+#include "StateIO.h"
+
+EwmaStats::EwmaStats(double alpha) : alpha(alpha) {
+    if (!(alpha > 0.0 && alpha <= 1.0)) {
+        throw std::invalid_argument("EwmaStats: alpha must be in (0, 1]");
+    }
+}
+
+double EwmaStats::alphaFromHalfLife(double halfLife) {
+    if (!(halfLife > 0.0)) {
+        throw std::invalid_argument("EwmaStats: halfLife must be positive");
+    }
+    return 1.0 - std::pow(0.5, 1.0 / halfLife);
+}
+
+void EwmaStats::update(double x) {
+    if (cnt++ == 0) {
+        mean = x;
+        var = 0.0;
+        return;
+    }
+    const double d = x - mean;
+    const double incr = alpha * d;
+    mean += incr;
+    var = (1.0 - alpha) * (var + d * incr);
+}
+
+double EwmaStats::getMean() const {
+    return mean;
+}
+
+double EwmaStats::getVar() const {
+    return var;
+}
+
+double EwmaStats::getStd() const {
+    return std::sqrt(var);
+}
+
+double EwmaStats::getAlpha() const {
+    return alpha;
+}
+
+int64_t EwmaStats::getCnt() const {
+    return cnt;
+}
+
+void EwmaStats::clear() {
+    mean = var = 0.0;
+    cnt = 0;
+}
+
+void EwmaStats::process(const double *x, size_t n, double *meanOut, double *stdOut) {
+    for (size_t i = 0; i < n; ++i) {
+        update(x[i]);
+        if (meanOut) meanOut[i] = mean;
+        if (stdOut) stdOut[i] = std::sqrt(var);
+    }
+}
+
+std::string EwmaStats::serialize() const {
+    StateWriter w("EWMA", 1);
+    w.put(alpha);
+    w.put(mean);
+    w.put(var);
+    w.put(cnt);
+    return w.str();
+}
+
+EwmaStats EwmaStats::deserialize(const std::string &state) {
+    StateReader r(state, "EWMA", 1);
+    EwmaStats res(r.get<double>());
+    res.mean = r.get<double>();
+    res.var = r.get<double>();
+    res.cnt = r.get<int64_t>();
+    r.finish();
+    return res;
+}
@@ -0,0 +1,47 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_EWMASTATS_H
+#define FFALCONXR_EWMASTATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Exponentially weighted mean and variance, O(1) memory:
+//   mean += alpha * (x - mean)
+//   var   = (1 - alpha) * (var + alpha * (x - mean_prev)^2)
+// which matches pandas ewm(alpha=alpha, adjust=False).mean() / .var(bias=True).
+// The first sample initialises the mean with variance 0.
+class EwmaStats {
+public:
+    explicit EwmaStats(double alpha);
+
+    // alpha for a given half-life (in samples), 1 - 0.5^(1 / halfLife)
+    static double alphaFromHalfLife(double halfLife);
+
+    void update(double x);
+
+    double getMean() const;
+    double getVar() const;
+    double getStd() const;
+    double getAlpha() const;
+    int64_t getCnt() const;
+    void clear();
+
+    // update for n samples; either output pointer may be null
+    void process(const double *x, size_t n, double *meanOut, double *stdOut);
+
+    // full state as a flat binary blob, see StateIO.h
+    std::string serialize() const;
+    static EwmaStats deserialize(const std::string &state);
+
+private:
+    double alpha;
+    double mean = 0.0, var = 0.0;
+    int64_t cnt = 0;
+};
+
+
+#endif //FFALCONXR_EWMASTATS_H
@@ -0,0 +1,20 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_FINITECHECK_H
+#define FFALCONXR_FINITECHECK_H
+
+#include <cstdint>
+#include <cstring>
+
+// The library is built with -ffast-math, which folds std::isnan / std::isfinite to
+// constants; look at the exponent bits directly (all ones is Inf/NaN).
+inline bool is_finite_bits(double x) {
+    uint64_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    return (u & 0x7ff0000000000000ull) != 0x7ff0000000000000ull;
+}
+
+
+#endif //FFALCONXR_FINITECHECK_H
@@ -3,58 +3,107 @@
 //
 
 #include "MKAverage.h"
+#include "StateIO.h"
+#include <stdexcept>
+#include "FiniteCheck.h"
 
-MKAverage::MKAverage(int m, int k) : m(m), k(k), sz(m - 2 * k) {
+MKAverage::MKAverage(int m, int k) : m(m), k(k), sz(m - 2 * k), sorted(m) {
     v = std::vector<double>(m);
 }
 
 void MKAverage::addElement(double num) {
-    if (pos >= m) {
-        remove(v[pos % m]);
+    // NaN could never be erased from the sorted list again and Inf - Inf poisons the sum
+    if (!is_finite_bits(num)) {
+        throw std::invalid_argument("MKAverage: samples must be finite");
+    }
+    if (cnt < m) {
+        sorted.insert(num);
+        v[pos] = num;
+        pos = (pos + 1) % m;
+        if (++cnt == m) {
+            sum = sorted.sum(k, m - k);
+        }
+        return;
+    }
+
+    // remove the oldest sample, the middle partition shrinks to [k, m - k - 1)
+    const double old = v[pos];
+    const int r = sorted.erase(old);
+    if (r < k) {
+        sum -= sorted.at(k - 1);
+    } else if (r < m - k) {
+        sum -= old;
+    } else {
+        sum -= sorted.at(m - k - 1);
+    }
+
+    // insert the new sample, the middle partition grows back to [k, m - k)
+    const int rank = sorted.insert(num);
+    v[pos] = num;
+    if (rank < k) {
+        sum += sorted.at(k);
+    } else if (rank < m - k) {
+        sum += num;
+    } else {
+        sum += sorted.at(m - k - 1);
+    }
+    pos = (pos + 1) % m;
+}
+
+void MKAverage::process(const double *x, size_t n, double *out) {
+    for (size_t i = 0; i < n; ++i) {
+        addElement(x[i]);
+        out[i] = calculateMKAverage();
     }
-    add(num);
-    v[pos++ % m] = num;
 }
 
 double MKAverage::calculateMKAverage() {
-    if (pos < m)
+    if (cnt < m)
         return 0.0f;
     return sum / (float) sz;
 }
 
-void MKAverage::remove(double n) {
-    if (n <= *left.rbegin())
-        left.erase(left.find(n));
-    else if (n <= *mid.rbegin()) {
-        auto it = mid.find(n);
-        sum -= *it;
-        mid.erase(it);
-    } else
-        right.erase(right.find(n));
-    if (left.size() < k) {
-        left.insert(*begin(mid));
-        sum -= *begin(mid);
-        mid.erase(begin(mid));
-    }
-    if (mid.size() < sz) {
-        mid.insert(*begin(right));
-        sum += *begin(right);
-        right.erase(begin(right));
-    }
+std::string MKAverage::serialize() const {
+    StateWriter w("MKAV", 1);
+    w.put<int32_t>(m);
+    w.put<int32_t>(k);
+    w.put<int32_t>(pos);
+    w.put<int32_t>(cnt);
+    w.put(sum);
+    w.putArray(v.data(), v.size());
+    return w.str();
 }
 
-void MKAverage::add(double n) {
-    left.insert(n);
-    if (left.size() > k) {
-        auto it = prev(end(left));
-        mid.insert(*it);
-        sum += *it;
-        left.erase(it);
+MKAverage MKAverage::deserialize(const std::string &state) {
+    StateReader r(state, "MKAV", 1);
+    const int m = r.get<int32_t>();
+    const int k = r.get<int32_t>();
+    const int pos = r.get<int32_t>();
+    const int cnt = r.get<int32_t>();
+    // while the window fills the ring is written from slot 0, so the next slot is the sample count
+    if (m <= 0 || k < 0 || k > m / 2 || pos < 0 || pos >= m || cnt < 0 || cnt > m || (cnt < m && pos != cnt)) {
+        throw std::invalid_argument("corrupt MKAverage state");
+    }
+    // the stored sum and the ring follow; checked before the ring of m values is allocated
+    if (r.remaining() != sizeof(double) * (1 + (size_t) m)) {
+        throw std::invalid_argument("corrupt MKAverage state");
+    }
+    MKAverage res(m, k);
+    res.pos = pos;
+    res.cnt = cnt;
+    r.get<double>();    // stored middle sum, recomputed below rather than trusted
+    r.getArray(res.v.data(), res.v.size());
+    r.finish();
+    // before the window fills the samples are v[0, cnt), afterwards the whole ring;
+    // addElement never admits NaN/Inf, so a ring holding one is corrupt
+    for (int i = 0; i < cnt; ++i) {
+        if (!is_finite_bits(res.v[i])) {
+            throw std::invalid_argument("corrupt MKAverage state");
+        }
+        res.sorted.insert(res.v[i]);
     }
-    if (mid.size() > sz) {
-        auto it = prev(end(mid));
-        sum -= *it;
-        right.insert(*it);
-        mid.erase(it);
+    if (cnt == m) {
+        res.sum = res.sorted.sum(k, m - k);
     }
+    return res;
 }
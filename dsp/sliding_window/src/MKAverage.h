@@ -6,22 +6,31 @@
 #define FFALCONXR_MKAVERAGE_H
 
 
+#include <cstddef>
+#include <string>
 #include <vector>
-#include <set>
+#include "BlockedSortedList.h"
 
 class MKAverage {
 public:
     MKAverage(int m, int k);
+    // throws std::invalid_argument on NaN/Inf, before any state is touched
     void addElement(double num);
     double calculateMKAverage();
-private:
-    void remove(double n);
-    void add(double n);
+    // addElement + calculateMKAverage for n samples, state carries over between calls
+    void process(const double *x, size_t n, double *out);
 
-    int m = 0, k = 0, sz = 0, pos = 0;
+    // full state (ring contents, ring position and middle sum) as a flat binary blob, see StateIO.h.
+    // The sorted partition and the middle sum are rebuilt from the ring on restore.
+    std::string serialize() const;
+    static MKAverage deserialize(const std::string &state);
+private:
+    int m = 0, k = 0, sz = 0, pos = 0, cnt = 0;
+    // sum of the elements ranked [k, m - k) once the window is full
     double sum = 0;
+    // ring of raw samples, oldest at `pos` once full
     std::vector<double> v;
-    std::multiset<double> left, mid, right;
+    BlockedSortedList sorted;
 };
 
 
@@ -3,33 +3,69 @@
 //
 
 #include "MonoQueue.h"
+#include "StateIO.h"
 
 MonoQueue::MonoQueue(int win) :
-        win(win),
-        cnt(0) {
+        m_deque(win),
+        cnt(0),
+        win(win) {
 }
 
 void MonoQueue::push(double val) {
-    int count = 0;
-    while (!m_deque.empty() && m_deque.back().first < val) {
-        count += m_deque.back().second + 1;
-        m_deque.pop_back();
-    }
-    m_deque.emplace_back(val, count);
-    cnt = std::min(cnt + 1, win + 1);
-    if (cnt > win) {
-        pop();
-    }
+    m_deque.evict(cnt - win + 1);
+    m_deque.push(val, cnt++);
 }
 
 double MonoQueue::max() {
-    return m_deque.front().first;
+    return m_deque.front();
+}
+
+void MonoQueue::process(const double *x, size_t n, double *out) {
+    for (size_t i = 0; i < n; ++i) {
+        push(x[i]);
+        out[i] = max();
+    }
 }
 
-void MonoQueue::pop() {
-    if (m_deque.front().second > 0) {
-        m_deque.front().second--;
-        return;
+std::string MonoQueue::serialize() const {
+    StateWriter w("MONQ", 1);
+    w.put<int32_t>(win);
+    w.put(cnt);
+    w.put<uint64_t>(m_deque.size());
+    for (size_t i = 0; i < m_deque.size(); ++i) {
+        w.put(m_deque[i]);
+        w.put(m_deque.indexAt(i));
+    }
+    return w.str();
+}
+
+MonoQueue MonoQueue::deserialize(const std::string &state) {
+    StateReader r(state, "MONQ", 1);
+    const int win = r.get<int32_t>();
+    const int64_t cnt = r.get<int64_t>();
+    const uint64_t n = r.get<uint64_t>();
+    // the newest sample is always the back of the deque, so the deque is empty exactly when cnt == 0;
+    // the n (value, index) pairs follow and are checked before the deque of win entries is allocated
+    if (win <= 0 || cnt < 0 || n > (uint64_t) win || (n == 0) != (cnt == 0)
+        || r.remaining() != n * (sizeof(double) + sizeof(int64_t))) {
+        throw std::invalid_argument("corrupt MonoQueue state");
+    }
+    MonoQueue res(win);
+    res.cnt = cnt;
+    double prevVal = 0.0;
+    int64_t prevIdx = res.cnt - win - 1;
+    for (uint64_t i = 0; i < n; ++i) {
+        // entries must lie in the window [cnt - win, cnt) with increasing indices and non-increasing
+        // values; then pushing them back in order keeps them all and push() can never overrun the deque
+        const double val = r.get<double>();
+        const int64_t idx = r.get<int64_t>();
+        if (idx <= prevIdx || idx >= res.cnt || (i > 0 && val > prevVal) || (i + 1 == n && idx != res.cnt - 1)) {
+            throw std::invalid_argument("corrupt MonoQueue state");
+        }
+        res.m_deque.push(val, idx);
+        prevVal = val;
+        prevIdx = idx;
     }
-    m_deque.pop_front();
+    r.finish();
+    return res;
 }
@@ -5,7 +5,11 @@
 #ifndef FFALCONXR_MONOQUEUE_H
 #define FFALCONXR_MONOQUEUE_H
 
-#include <deque>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "MonotonicDeque.h"
 
 class MonoQueue {
 public:
@@ -15,13 +19,17 @@ public:
 
     double max();
 
-private:
-    void pop();
+    // push + max for n samples, state carries over between calls
+    void process(const double *x, size_t n, double *out);
+
+    // full state (sample counter and deque contents) as a flat binary blob, see StateIO.h
+    std::string serialize() const;
+    static MonoQueue deserialize(const std::string &state);
 
-    //pair.first: the actual value,
-    //pair.second: how many elements were deleted between it and the one before it.
-    std::deque<std::pair<double, int>> m_deque;
-    int cnt;
+private:
+    //decreasing values tagged with their sample index, capacity win
+    MonotonicDeque<double, std::less<double>> m_deque;
+    int64_t cnt;
     int win;
 };
 
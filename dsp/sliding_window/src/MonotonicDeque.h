@@ -0,0 +1,103 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_MONOTONICDEQUE_H
+#define FFALCONXR_MONOTONICDEQUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Circular monotonic deque for sliding extrema over a window of `capacity` samples.
+// comp(back, x) == true means x dominates back: std::less tracks the maximum,
+// std::greater the minimum. Equal values are kept, so front() is the oldest extreme.
+// Key tags every entry with its position in the stream: a sample index for
+// count windows, a timestamp for time windows.
+template<typename T, typename Compare = std::less<T>, typename Key = int64_t>
+class MonotonicDeque {
+public:
+    explicit MonotonicDeque(size_t capacity) : values(capacity > 0 ? capacity : 1), indices(values.size()) {}
+
+    // append sample `index`, dropping everything it dominates.
+    // Evict the sample leaving the window first so the deque never exceeds its capacity.
+    void push(T value, Key index) {
+        while (count > 0 && comp(values[last()], value)) {
+            count--;
+        }
+        size_t j = head + count;
+        if (j >= values.size()) j -= values.size();
+        values[j] = value;
+        indices[j] = index;
+        count++;
+    }
+
+    // drop samples whose key is older than `first`.
+    void evict(Key first) {
+        while (count > 0 && indices[head] < first) {
+            popFront();
+        }
+    }
+
+    // drop samples whose key is `last` or older.
+    void evictThrough(Key last) {
+        while (count > 0 && !(last < indices[head])) {
+            popFront();
+        }
+    }
+
+    // double the capacity, keeping the contents; only for windows without a fixed size.
+    void grow() {
+        std::vector<T> v(values.size() * 2);
+        std::vector<Key> k(v.size());
+        for (size_t i = 0; i < count; ++i) {
+            size_t j = head + i;
+            if (j >= values.size()) j -= values.size();
+            v[i] = values[j];
+            k[i] = indices[j];
+        }
+        values.swap(v);
+        indices.swap(k);
+        head = 0;
+    }
+
+    T front() const { return values[head]; }
+
+    Key frontIndex() const { return indices[head]; }
+
+    // i-th entry counted from the front
+    T operator[](size_t i) const { return values[wrap(head + i)]; }
+
+    Key indexAt(size_t i) const { return indices[wrap(head + i)]; }
+
+    size_t size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    bool full() const { return count == values.size(); }
+
+    void clear() { head = count = 0; }
+
+private:
+    void popFront() {
+        head = head + 1 == values.size() ? 0 : head + 1;
+        count--;
+    }
+
+    size_t last() const {
+        return wrap(head + count - 1);
+    }
+
+    size_t wrap(size_t j) const {
+        return j < values.size() ? j : j - values.size();
+    }
+
+    std::vector<T> values;
+    std::vector<Key> indices;
+    size_t head = 0, count = 0;
+    Compare comp;
+};
+
+
+#endif //FFALCONXR_MONOTONICDEQUE_H
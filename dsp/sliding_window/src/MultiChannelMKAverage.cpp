@@ -0,0 +1,37 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#include "MultiChannelMKAverage.h"
+#include <cstring>
+#include <stdexcept>
+
+MultiChannelMKAverage::MultiChannelMKAverage(int m, int k, int channels) : channels(channels) {
+    if (channels <= 0) {
+        throw std::invalid_argument("MultiChannelMKAverage: channels must be positive");
+    }
+    lanes = std::vector<MKAverage>(channels, MKAverage(m, k));
+    out = std::vector<double>(channels);
+}
+
+const double *MultiChannelMKAverage::push(const double *row) {
+    for (int c = 0; c < channels; ++c) {
+        lanes[c].addElement(row[c]);
+        out[c] = lanes[c].calculateMKAverage();
+    }
+    return out.data();
+}
+
+void MultiChannelMKAverage::process(const double *x, size_t T, double *dst) {
+    for (size_t t = 0; t < T; ++t) {
+        std::memcpy(dst + t * channels, push(x + t * channels), sizeof(double) * channels);
+    }
+}
+
+const double *MultiChannelMKAverage::calculateMKAverage() const {
+    return out.data();
+}
+
+int MultiChannelMKAverage::getChannels() const {
+    return channels;
+}
@@ -0,0 +1,35 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_MULTICHANNELMKAVERAGE_H
+#define FFALCONXR_MULTICHANNELMKAVERAGE_H
+
+#include <cstddef>
+#include <vector>
+#include "MKAverage.h"
+
+// MKAverage over `channels` synchronized streams with a (T, channels) interface.
+// Order statistics do not vectorize across channels, so each channel keeps its own
+// allocation-free MKAverage; only the row bookkeeping is shared.
+class MultiChannelMKAverage {
+public:
+    MultiChannelMKAverage(int m, int k, int channels);
+
+    // one timestamp: row[c] for c in [0, channels); returns the per-channel MK average
+    const double *push(const double *row);
+
+    // T timestamps of a row-major (T, channels) block, written to out (T, channels)
+    void process(const double *x, size_t T, double *out);
+
+    const double *calculateMKAverage() const;
+    int getChannels() const;
+
+private:
+    int channels;
+    std::vector<MKAverage> lanes;
+    std::vector<double> out;
+};
+
+
+#endif //FFALCONXR_MULTICHANNELMKAVERAGE_H
@@ -0,0 +1,73 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#include "MultiChannelMonoQueue.h"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "SimdLanes.h"
+
+MultiChannelMonoQueue::MultiChannelMonoQueue(int win, int channels) :
+        win(win),
+        channels(channels),
+        stride(SimdLanes::padded(channels)) {
+    if (win <= 0 || channels <= 0) {
+        throw std::invalid_argument("MultiChannelMonoQueue: win and channels must be positive");
+    }
+    block = std::vector<double>((size_t) win * stride);
+    // no previous block yet: the window max is the max seen so far
+    suffix = std::vector<double>((size_t) win * stride, std::numeric_limits<double>::lowest());
+    prefix = std::vector<double>(stride);
+    out = std::vector<double>(stride);
+}
+
+const double *MultiChannelMonoQueue::push(const double *in) {
+    using L = SimdLanes;
+    double *cur = block.data() + (size_t) pos * stride;
+    std::memcpy(cur, in, sizeof(double) * channels);
+
+    if (pos == 0) {
+        std::memcpy(prefix.data(), cur, sizeof(double) * stride);
+    } else {
+        for (int c = 0; c < stride; c += L::width) {
+            L::store(&prefix[c], L::max(L::load(&prefix[c]), L::load(&cur[c])));
+        }
+    }
+
+    if (pos == win - 1) {
+        // the window is exactly the current block; turn it into the next suffix table
+        std::memcpy(out.data(), prefix.data(), sizeof(double) * stride);
+        double *next = suffix.data() + (size_t) (win - 1) * stride;
+        std::memcpy(next, block.data() + (size_t) (win - 1) * stride, sizeof(double) * stride);
+        for (int j = win - 2; j >= 0; --j) {
+            const double *b = block.data() + (size_t) j * stride;
+            double *s = suffix.data() + (size_t) j * stride;
+            for (int c = 0; c < stride; c += L::width) {
+                L::store(&s[c], L::max(L::load(&b[c]), L::load(&s[c + stride])));
+            }
+        }
+        pos = 0;
+    } else {
+        const double *s = suffix.data() + (size_t) (pos + 1) * stride;
+        for (int c = 0; c < stride; c += L::width) {
+            L::store(&out[c], L::max(L::load(&s[c]), L::load(&prefix[c])));
+        }
+        pos++;
+    }
+    return out.data();
+}
+
+void MultiChannelMonoQueue::process(const double *x, size_t T, double *dst) {
+    for (size_t t = 0; t < T; ++t) {
+        std::memcpy(dst + t * channels, push(x + t * channels), sizeof(double) * channels);
+    }
+}
+
+const double *MultiChannelMonoQueue::max() const {
+    return out.data();
+}
+
+int MultiChannelMonoQueue::getChannels() const {
+    return channels;
+}
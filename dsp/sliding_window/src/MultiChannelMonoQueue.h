@@ -0,0 +1,40 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_MULTICHANNELMONOQUEUE_H
+#define FFALCONXR_MULTICHANNELMONOQUEUE_H
+
+#include <cstddef>
+#include <vector>
+
+// Sliding max over `channels` synchronized streams.
+// A per-channel monotonic deque branches on the data, so this uses the van Herk /
+// Gil-Werman scheme instead: the stream is cut into blocks of `win` samples, the
+// window max is max(suffix max of the previous block, prefix max of the current one).
+// That is two SIMD max operations per row plus one backward pass per block.
+class MultiChannelMonoQueue {
+public:
+    MultiChannelMonoQueue(int win, int channels);
+
+    // one timestamp: row[c] for c in [0, channels); returns the per-channel max
+    const double *push(const double *row);
+
+    // T timestamps of a row-major (T, channels) block, max written to out (T, channels)
+    void process(const double *x, size_t T, double *out);
+
+    const double *max() const;
+    int getChannels() const;
+
+private:
+    int win;
+    int channels;
+    int stride;
+    int pos = 0;
+    std::vector<double> block;    // raw rows of the current block
+    std::vector<double> suffix;   // suffix maxima of the previous block
+    std::vector<double> prefix, out;
+};
+
+
+#endif //FFALCONXR_MULTICHANNELMONOQUEUE_H
@@ -0,0 +1,85 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#include "MultiChannelWelfordStd.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "SimdLanes.h"
+
+MultiChannelWelfordStd::MultiChannelWelfordStd(int win, int channels) :
+        win(win),
+        channels(channels),
+        stride(SimdLanes::padded(channels)) {
+    if (win <= 0 || channels <= 0) {
+        throw std::invalid_argument("MultiChannelWelfordStd: win and channels must be positive");
+    }
+    avg = std::vector<double>(stride);
+    var = std::vector<double>(stride);
+    std = std::vector<double>(stride);
+    row = std::vector<double>(stride);
+    window = std::vector<double>((size_t) win * stride);
+}
+
+const double *MultiChannelWelfordStd::push(const double *in) {
+    using L = SimdLanes;
+    // same recurrences as WelfordStd::calcSlidingStd, one lane per channel
+    std::memcpy(row.data(), in, sizeof(double) * channels);
+    cnt = std::min({cnt + 1, 100 * win});
+    double *old = window.data() + (size_t) slot * stride;
+
+    if (cnt <= win) {
+        const L::reg n = L::set1((double) cnt);
+        for (int c = 0; c < stride; c += L::width) {
+            const L::reg x = L::load(&row[c]);
+            const L::reg pre = L::load(&avg[c]);
+            const L::reg a = L::add(pre, L::div(L::sub(x, pre), n));
+            L::store(&avg[c], a);
+            L::store(&var[c], L::add(L::load(&var[c]), L::mul(L::sub(x, a), L::sub(x, pre))));
+        }
+    } else {
+        const L::reg w = L::set1((double) win);
+        for (int c = 0; c < stride; c += L::width) {
+            const L::reg x = L::load(&row[c]);
+            const L::reg o = L::load(&old[c]);
+            const L::reg pre = L::load(&avg[c]);
+            const L::reg a = L::add(pre, L::div(L::sub(x, o), w));
+            L::store(&avg[c], a);
+            const L::reg dv = L::mul(L::sub(x, o), L::add(L::sub(x, a), L::sub(o, pre)));
+            L::store(&var[c], L::add(L::load(&var[c]), dv));
+        }
+    }
+    std::memcpy(old, row.data(), sizeof(double) * stride);
+    slot = slot + 1 == win ? 0 : slot + 1;
+
+    const int dof = cnt >= win ? win - 1 : cnt - 1;
+    if (dof <= 0) {
+        std::fill(std.begin(), std.end(), 0.0);
+    } else {
+        const L::reg d = L::set1((double) dof);
+        const L::reg zero = L::set1(0.0);
+        for (int c = 0; c < stride; c += L::width) {
+            L::store(&std[c], L::sqrt(L::div(L::max(L::load(&var[c]), zero), d)));
+        }
+    }
+    return std.data();
+}
+
+void MultiChannelWelfordStd::process(const double *x, size_t T, double *out) {
+    for (size_t t = 0; t < T; ++t) {
+        std::memcpy(out + t * channels, push(x + t * channels), sizeof(double) * channels);
+    }
+}
+
+const double *MultiChannelWelfordStd::getStd() const {
+    return std.data();
+}
+
+int MultiChannelWelfordStd::getCnt() const {
+    return cnt;
+}
+
+int MultiChannelWelfordStd::getChannels() const {
+    return channels;
+}
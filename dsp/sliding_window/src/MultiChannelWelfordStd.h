@@ -0,0 +1,39 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_MULTICHANNELWELFORDSTD_H
+#define FFALCONXR_MULTICHANNELWELFORDSTD_H
+
+#include <cstddef>
+#include <vector>
+
+// WelfordStd over `channels` synchronized streams. Every accumulator is an array
+// indexed by channel and the window is a ring of channel rows, so one push()
+// updates all channels with SIMD lanes (see SimdLanes.h).
+class MultiChannelWelfordStd {
+public:
+    MultiChannelWelfordStd(int win, int channels);
+
+    // one timestamp: row[c] for c in [0, channels); returns the per-channel std
+    const double *push(const double *row);
+
+    // T timestamps of a row-major (T, channels) block, std written to out (T, channels)
+    void process(const double *x, size_t T, double *out);
+
+    const double *getStd() const;
+    int getCnt() const;
+    int getChannels() const;
+
+private:
+    int win;
+    int channels;
+    int stride;   // channels padded to the SIMD width
+    int cnt = 0;
+    int slot = 0;
+    std::vector<double> avg, var, std, row;
+    std::vector<double> window;   // win rows of `stride` values
+};
+
+
+#endif //FFALCONXR_MULTICHANNELWELFORDSTD_H
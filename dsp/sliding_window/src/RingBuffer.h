@@ -0,0 +1,71 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_RINGBUFFER_H
+#define FFALCONXR_RINGBUFFER_H
+
+#include <cstddef>
+#include <vector>
+
+// Fixed-capacity FIFO. Storage is allocated once in the constructor,
+// push() on a full buffer overwrites the oldest element. Windows without a
+// fixed size call grow() before pushing into a full buffer instead.
+template<typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity) : buf(capacity > 0 ? capacity : 1) {}
+
+    void push(T value) {
+        buf[tail] = value;
+        tail = tail + 1 == buf.size() ? 0 : tail + 1;
+        if (count < buf.size()) {
+            count++;
+        } else {
+            head = tail;
+        }
+    }
+
+    void popFront() {
+        head = head + 1 == buf.size() ? 0 : head + 1;
+        count--;
+    }
+
+    // i-th element counted from the oldest
+    T operator[](size_t i) const {
+        const size_t j = head + i;
+        return buf[j < buf.size() ? j : j - buf.size()];
+    }
+
+    // double the capacity, keeping the contents in order
+    void grow() {
+        std::vector<T> next(buf.size() * 2);
+        for (size_t i = 0; i < count; ++i) {
+            next[i] = (*this)[i];
+        }
+        buf.swap(next);
+        head = 0;
+        tail = count;
+    }
+
+    T front() const { return buf[head]; }
+
+    T back() const { return buf[tail == 0 ? buf.size() - 1 : tail - 1]; }
+
+    size_t size() const { return count; }
+
+    size_t capacity() const { return buf.size(); }
+
+    bool full() const { return count == buf.size(); }
+
+    bool empty() const { return count == 0; }
+
+    void clear() { head = tail = count = 0; }
+
+private:
+    std::vector<T> buf;
+    size_t head = 0, tail = 0, count = 0;
+};
+
+
+#endif //FFALCONXR_RINGBUFFER_H
@@ -0,0 +1,69 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_SIMDLANES_H
+#define FFALCONXR_SIMDLANES_H
+
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Thin wrapper over the widest double-precision vector the target supports:
+// AVX (4 lanes), NEON on aarch64 (2 lanes), otherwise a plain scalar.
+// Multi-channel kernels are written once against it and process `width` channels per step.
+struct SimdLanes {
+#if defined(__AVX__)
+    using reg = __m256d;
+    static constexpr int width = 4;
+
+    static reg load(const double *p) { return _mm256_loadu_pd(p); }
+    static void store(double *p, reg v) { _mm256_storeu_pd(p, v); }
+    static reg set1(double v) { return _mm256_set1_pd(v); }
+    static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+    static reg sqrt(reg a) { return _mm256_sqrt_pd(a); }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    using reg = float64x2_t;
+    static constexpr int width = 2;
+
+    static reg load(const double *p) { return vld1q_f64(p); }
+    static void store(double *p, reg v) { vst1q_f64(p, v); }
+    static reg set1(double v) { return vdupq_n_f64(v); }
+    static reg add(reg a, reg b) { return vaddq_f64(a, b); }
+    static reg sub(reg a, reg b) { return vsubq_f64(a, b); }
+    static reg mul(reg a, reg b) { return vmulq_f64(a, b); }
+    static reg div(reg a, reg b) { return vdivq_f64(a, b); }
+    static reg max(reg a, reg b) { return vmaxq_f64(a, b); }
+    static reg min(reg a, reg b) { return vminq_f64(a, b); }
+    static reg sqrt(reg a) { return vsqrtq_f64(a); }
+#else
+    using reg = double;
+    static constexpr int width = 1;
+
+    static reg load(const double *p) { return *p; }
+    static void store(double *p, reg v) { *p = v; }
+    static reg set1(double v) { return v; }
+    static reg add(reg a, reg b) { return a + b; }
+    static reg sub(reg a, reg b) { return a - b; }
+    static reg mul(reg a, reg b) { return a * b; }
+    static reg div(reg a, reg b) { return a / b; }
+    static reg max(reg a, reg b) { return a < b ? b : a; }
+    static reg min(reg a, reg b) { return b < a ? b : a; }
+    static reg sqrt(reg a) { return std::sqrt(a); }
+#endif
+
+    // channel count rounded up to a whole number of vectors
+    static int padded(int channels) { return (channels + width - 1) / width * width; }
+};
+
+
+#endif //FFALCONXR_SIMDLANES_H
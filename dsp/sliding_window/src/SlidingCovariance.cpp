@@ -0,0 +1,113 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#include "SlidingCovariance.h"
+#include <algorithm>
+#include <cmath>
+
+SlidingCovariance::SlidingCovariance(int win) : win(win), window(win) {
+}
+
+void SlidingCovariance::push(double x, double y) {
+    const Pair old = window.front();
+    window.push({x, y});
+    const double preX = meanX, preY = meanY;
+    if (cnt < win) {
+        cnt++;
+        const double dx = x - preX;
+        meanX += dx / (double) cnt;
+        meanY += (y - preY) / (double) cnt;
+        m2x += dx * (x - meanX);
+        m2y += (y - preY) * (y - meanY);
+        cxy += dx * (y - meanY);
+    } else {
+        // replace the oldest pair, see WelfordStd::calcSlidingStd
+        const double dx = x - old.x, dy = y - old.y;
+        meanX += dx / (double) win;
+        meanY += dy / (double) win;
+        m2x += dx * (x - meanX + old.x - preX);
+        m2y += dy * (y - meanY + old.y - preY);
+        cxy += dx * (y - meanY) + dy * (old.x - preX);
+        if (++sinceRebuild == win) {
+            rebuild();
+        }
+    }
+}
+
+// two-pass recomputation from the ring, once per `win` replacements (amortized O(1)):
+// drops the residue the replace updates accumulate, so a window that has become
+// constant reads exactly 0 variance, correlation and slope
+void SlidingCovariance::rebuild() {
+    sinceRebuild = 0;
+    double sx = 0.0, sy = 0.0;
+    for (size_t i = 0; i < window.size(); ++i) {
+        sx += window[i].x;
+        sy += window[i].y;
+    }
+    meanX = sx / (double) window.size();
+    meanY = sy / (double) window.size();
+    m2x = m2y = cxy = 0.0;
+    for (size_t i = 0; i < window.size(); ++i) {
+        const double dx = window[i].x - meanX, dy = window[i].y - meanY;
+        m2x += dx * dx;
+        m2y += dy * dy;
+        cxy += dx * dy;
+    }
+}
+
+double SlidingCovariance::getCov() const {
+    return cnt <= 1 ? 0.0 : cxy / (double) (cnt - 1);
+}
+
+double SlidingCovariance::getCorr() const {
+    if (m2x <= 0.0 || m2y <= 0.0)
+        return 0.0;
+    return std::max(-1.0, std::min(1.0, cxy / std::sqrt(m2x * m2y)));
+}
+
+double SlidingCovariance::getSlope() const {
+    return m2x <= 0.0 ? 0.0 : cxy / m2x;
+}
+
+double SlidingCovariance::getIntercept() const {
+    return meanY - getSlope() * meanX;
+}
+
+double SlidingCovariance::getMeanX() const {
+    return meanX;
+}
+
+double SlidingCovariance::getMeanY() const {
+    return meanY;
+}
+
+double SlidingCovariance::getStdX() const {
+    return cnt <= 1 ? 0.0 : std::sqrt(std::max(m2x, 0.0) / (double) (cnt - 1));
+}
+
+double SlidingCovariance::getStdY() const {
+    return cnt <= 1 ? 0.0 : std::sqrt(std::max(m2y, 0.0) / (double) (cnt - 1));
+}
+
+int SlidingCovariance::getCnt() const {
+    return cnt;
+}
+
+void SlidingCovariance::clear() {
+    cnt = sinceRebuild = 0;
+    meanX = meanY = m2x = m2y = cxy = 0.0;
+    window.clear();
+}
+
+void SlidingCovariance::process(const double *x, const double *y, size_t n,
+                                double *covOut, double *corrOut,
+                                double *slopeOut, double *interceptOut) {
+    for (size_t i = 0; i < n; ++i) {
+        push(x[i], y[i]);
+        if (covOut) covOut[i] = getCov();
+        if (corrOut) corrOut[i] = getCorr();
+        if (slopeOut) slopeOut[i] = getSlope();
+        if (interceptOut) interceptOut[i] = getIntercept();
+    }
+}
@@ -0,0 +1,57 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_SLIDINGCOVARIANCE_H
+#define FFALCONXR_SLIDINGCOVARIANCE_H
+
+#include <cstddef>
+#include "RingBuffer.h"
+
+// Covariance, Pearson correlation and the least-squares line y = slope * x + intercept
+// over the last `win` (x, y) pairs. Uses the same O(1) add/replace updates as
+// WelfordStd, extended to the co-moment sum((x - mean_x) * (y - mean_y)), plus an
+// exact recomputation from the ring every `win` samples to stop rounding drift.
+// Covariance uses ddof = 1 like WelfordStd. Correlation and slope are 0 when a
+// stream is constant over the window.
+class SlidingCovariance {
+public:
+    SlidingCovariance(int win);
+
+    void push(double x, double y);
+
+    double getCov() const;
+    double getCorr() const;
+    double getSlope() const;
+    double getIntercept() const;
+    double getMeanX() const;
+    double getMeanY() const;
+    double getStdX() const;
+    double getStdY() const;
+    int getCnt() const;
+    void clear();
+
+    // push n pairs; any of the output pointers may be null
+    void process(const double *x, const double *y, size_t n,
+                 double *covOut, double *corrOut,
+                 double *slopeOut, double *interceptOut);
+
+private:
+    void rebuild();
+
+    struct Pair {
+        double x;
+        double y;
+    };
+
+    int win;
+    int cnt = 0;
+    int sinceRebuild = 0;
+    double meanX = 0.0, meanY = 0.0;
+    // sums of squared / cross deviations from the means
+    double m2x = 0.0, m2y = 0.0, cxy = 0.0;
+    RingBuffer<Pair> window;
+};
+
+
+#endif //FFALCONXR_SLIDINGCOVARIANCE_H
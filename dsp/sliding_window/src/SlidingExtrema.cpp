@@ -0,0 +1,59 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#include "SlidingExtrema.h"
+
+SlidingExtrema::SlidingExtrema(int win) : maxq(win), minq(win), win(win) {
+}
+
+void SlidingExtrema::push(double val) {
+    const int64_t first = cnt - win + 1;
+    maxq.evict(first);
+    minq.evict(first);
+    maxq.push(val, cnt);
+    minq.push(val, cnt);
+    cnt++;
+}
+
+double SlidingExtrema::min() const {
+    return minq.front();
+}
+
+double SlidingExtrema::max() const {
+    return maxq.front();
+}
+
+int64_t SlidingExtrema::argmin() const {
+    return minq.frontIndex();
+}
+
+int64_t SlidingExtrema::argmax() const {
+    return maxq.frontIndex();
+}
+
+double SlidingExtrema::range() const {
+    return maxq.front() - minq.front();
+}
+
+int64_t SlidingExtrema::getCnt() const {
+    return cnt;
+}
+
+void SlidingExtrema::clear() {
+    maxq.clear();
+    minq.clear();
+    cnt = 0;
+}
+
+void SlidingExtrema::process(const double *x, size_t n,
+                             double *minOut, double *maxOut,
+                             int64_t *argminOut, int64_t *argmaxOut) {
+    for (size_t i = 0; i < n; ++i) {
+        push(x[i]);
+        if (minOut) minOut[i] = minq.front();
+        if (maxOut) maxOut[i] = maxq.front();
+        if (argminOut) argminOut[i] = minq.frontIndex();
+        if (argmaxOut) argmaxOut[i] = maxq.frontIndex();
+    }
+}
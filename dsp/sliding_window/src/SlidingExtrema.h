@@ -0,0 +1,44 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_SLIDINGEXTREMA_H
+#define FFALCONXR_SLIDINGEXTREMA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "MonotonicDeque.h"
+
+// Sliding min, max, their sample indices and the peak-to-peak range over the last
+// `win` samples, from one push per sample. Both monotonic deques live in storage
+// sized at construction. Indices count samples since construction (or clear());
+// ties resolve to the oldest sample, like np.argmax/np.argmin over the window.
+class SlidingExtrema {
+public:
+    SlidingExtrema(int win);
+
+    void push(double val);
+
+    double min() const;
+    double max() const;
+    int64_t argmin() const;
+    int64_t argmax() const;
+    double range() const;
+    int64_t getCnt() const;
+    void clear();
+
+    // push n samples; any of the output pointers may be null
+    void process(const double *x, size_t n,
+                 double *minOut, double *maxOut,
+                 int64_t *argminOut, int64_t *argmaxOut);
+
+private:
+    MonotonicDeque<double, std::less<double>> maxq;
+    MonotonicDeque<double, std::greater<double>> minq;
+    int64_t cnt = 0;
+    int win;
+};
+
+
+#endif //FFALCONXR_SLIDINGEXTREMA_H
@@ -0,0 +1,145 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#include "SlidingQuantile.h"
+#include <algorithm>
+#include <stdexcept>
+#include "FiniteCheck.h"
+
+SlidingQuantile::SlidingQuantile(int m, double q) : q(q), window(m), sorted(m) {
+    if (q < 0.0 || q > 1.0) {
+        throw std::invalid_argument("SlidingQuantile: q must be in [0, 1]");
+    }
+}
+
+void SlidingQuantile::push(double val) {
+    // NaN could never be erased from the sorted list again
+    if (!is_finite_bits(val)) {
+        throw std::invalid_argument("SlidingQuantile: samples must be finite");
+    }
+    if (window.full()) {
+        sorted.erase(window.front());
+    }
+    window.push(val);
+    sorted.insert(val);
+    cached = sorted.quantile(q);
+}
+
+double SlidingQuantile::value() const {
+    return cached;
+}
+
+double SlidingQuantile::median() const {
+    return q == 0.5 ? cached : sorted.quantile(0.5);
+}
+
+double SlidingQuantile::quantile(double p) const {
+    return sorted.quantile(p);
+}
+
+int SlidingQuantile::getCnt() const {
+    return sorted.size();
+}
+
+void SlidingQuantile::clear() {
+    window.clear();
+    sorted.clear();
+    cached = 0.0;
+}
+
+void SlidingQuantile::process(const double *x, size_t n, double *out) {
+    // checked up front so a rejected batch leaves the window untouched
+    for (size_t i = 0; i < n; ++i) {
+        if (!is_finite_bits(x[i])) {
+            throw std::invalid_argument("SlidingQuantile: samples must be finite");
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        push(x[i]);
+        out[i] = cached;
+    }
+}
+
+ApproxSlidingQuantile::ApproxSlidingQuantile(int m, double q, int blocks, int resolution) :
+        q(q),
+        blocks(blocks),
+        blockSize((m + blocks - 1) / std::max(blocks, 1)),
+        resolution(std::min(resolution, blockSize)),
+        merged(std::max(blocks * std::min(resolution, blockSize), 1)) {
+    if (q < 0.0 || q > 1.0) {
+        throw std::invalid_argument("ApproxSlidingQuantile: q must be in [0, 1]");
+    }
+    if (m <= 0 || blocks <= 0 || resolution <= 0) {
+        throw std::invalid_argument("ApproxSlidingQuantile: m, blocks and resolution must be positive");
+    }
+    current = std::vector<double>(blockSize);
+    summaries = std::vector<double>((size_t) blocks * this->resolution);
+}
+
+void ApproxSlidingQuantile::push(double val) {
+    // std::sort on a block holding NaN is undefined and the merged list could never erase it
+    if (!is_finite_bits(val)) {
+        throw std::invalid_argument("ApproxSlidingQuantile: samples must be finite");
+    }
+    current[fill++] = val;
+    cnt++;
+    if (fill == blockSize) {
+        sealBlock();
+        fill = 0;
+    }
+}
+
+void ApproxSlidingQuantile::sealBlock() {
+    std::sort(current.begin(), current.end());
+    double *slot = summaries.data() + (size_t) oldest * resolution;
+    if (sealed == blocks) {
+        for (int i = 0; i < resolution; ++i) {
+            merged.erase(slot[i]);
+        }
+    } else {
+        sealed++;
+    }
+    // midpoints of `resolution` equal-count slices of the sorted block
+    for (int i = 0; i < resolution; ++i) {
+        slot[i] = current[(size_t) ((2 * i + 1) * (long long) blockSize / (2 * resolution))];
+        merged.insert(slot[i]);
+    }
+    oldest = oldest + 1 == blocks ? 0 : oldest + 1;
+    cached = merged.quantile(q);
+}
+
+double ApproxSlidingQuantile::value() const {
+    return cached;
+}
+
+double ApproxSlidingQuantile::median() const {
+    return q == 0.5 ? cached : merged.quantile(0.5);
+}
+
+double ApproxSlidingQuantile::quantile(double p) const {
+    return merged.quantile(p);
+}
+
+long long ApproxSlidingQuantile::getCnt() const {
+    return cnt;
+}
+
+void ApproxSlidingQuantile::clear() {
+    fill = sealed = oldest = 0;
+    cnt = 0;
+    cached = 0.0;
+    merged.clear();
+}
+
+void ApproxSlidingQuantile::process(const double *x, size_t n, double *out) {
+    for (size_t i = 0; i < n; ++i) {
+        if (!is_finite_bits(x[i])) {
+            throw std::invalid_argument("ApproxSlidingQuantile: samples must be finite");
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        push(x[i]);
+        out[i] = cached;
+    }
+}
@@ -0,0 +1,94 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_SLIDINGQUANTILE_H
+#define FFALCONXR_SLIDINGQUANTILE_H
+
+#include <cstddef>
+#include <vector>
+#include "BlockedSortedList.h"
+#include "RingBuffer.h"
+
+// Exact sliding quantile over the last m samples (fewer while warming up).
+// The window is kept sorted in the same pooled BlockedSortedList MKAverage uses,
+// so push() never allocates. push() costs O(sqrt(m)): a binary search over the
+// block maxima, a memmove inside one block of ~2 sqrt(m) values and a walk over
+// the block counts to refresh the quantile fixed at construction (blocks are capped
+// at 1024 values, so past m ~ 2^18 the walk grows as m / 1024 instead). value() (and
+// median() when q == 0.5) returns that cached result in O(1); any other
+// quantile(p) repeats the rank walk.
+// Memory: the m-sample ring buffer plus the list's pool of ~4 m values.
+// Values are interpolated linearly between ranks, matching np.quantile.
+// NaN/Inf samples throw std::invalid_argument before the window is touched.
+class SlidingQuantile {
+public:
+    SlidingQuantile(int m, double q = 0.5);
+
+    void push(double val);
+
+    // the configured quantile of the current window
+    double value() const;
+    double median() const;
+    double quantile(double p) const;
+    int getCnt() const;
+    void clear();
+
+    // push + value for n samples, state carries over between calls
+    void process(const double *x, size_t n, double *out);
+
+private:
+    double q;
+    double cached = 0.0;
+    RingBuffer<double> window;
+    BlockedSortedList sorted;
+};
+
+// Approximate sliding quantile for windows too large to keep sorted (10^6 samples and up).
+// The window is cut into `blocks` blocks of ceil(m / blocks) samples, so the window
+// actually covered is blocks * ceil(m / blocks) samples (1008 for m = 1000, blocks = 16);
+// pick m as a multiple of blocks for an exact m. Each completed block is
+// sorted once and reduced to `resolution` evenly spaced order statistics; all summaries
+// carry the same weight, so the quantile of the window is the quantile of the union of
+// the summaries. Memory is m / blocks values for the block being filled, blocks * resolution
+// for the summaries and the merged BlockedSortedList's pool of ~4 * blocks * resolution,
+// i.e. about m / blocks + 5 * blocks * resolution values instead of ~5 m.
+// push() is O(1) except when a block completes: sorting it and replacing its summary in
+// the merged list costs O(m / blocks * log(m / blocks) + resolution * sqrt(blocks * resolution)).
+// value() (and median() when q == 0.5) is O(1), other quantiles O(sqrt(blocks * resolution)).
+// Error: at most 1 / (2 * resolution) in rank, and the window advances in whole blocks,
+// so the answer lags the exact window by up to m / blocks samples.
+// Before the first block completes value() returns 0. NaN/Inf samples throw std::invalid_argument.
+class ApproxSlidingQuantile {
+public:
+    ApproxSlidingQuantile(int m, double q = 0.5, int blocks = 64, int resolution = 256);
+
+    void push(double val);
+
+    double value() const;
+    double median() const;
+    double quantile(double p) const;
+    long long getCnt() const;
+    void clear();
+
+    void process(const double *x, size_t n, double *out);
+
+private:
+    void sealBlock();
+
+    double q;
+    int blocks;
+    int blockSize;
+    int resolution;
+    int fill = 0;
+    int sealed = 0;     // completed blocks currently summarized, <= blocks
+    int oldest = 0;     // summary slot to be replaced next
+    long long cnt = 0;
+    double cached = 0.0;
+    std::vector<double> current;     // raw samples of the block being filled
+    std::vector<double> summaries;   // blocks x resolution order statistics
+    BlockedSortedList merged;
+};
+
+
+#endif //FFALCONXR_SLIDINGQUANTILE_H
@@ -0,0 +1,91 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_SLIDINGSTATS_H
+#define FFALCONXR_SLIDINGSTATS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "Accumulator.h"
+#include "MonotonicDeque.h"
+#include "RingBuffer.h"
+
+// Count, mean, sample variance/std, min and max over the last `win` samples.
+// All storage is sized in the constructor, push() is O(1) amortized and never allocates.
+// T selects float or double; Compensated keeps the mean and M2 accumulators in
+// Neumaier sums so their rounding error does not build up over long streams.
+template<typename T = double, bool Compensated = false>
+class SlidingStats {
+public:
+    explicit SlidingStats(int win) : win(win), ring(win), maxq(win), minq(win) {}
+
+    void push(T x) {
+        const int64_t index = seen++;
+        maxq.evict(index - win + 1);
+        minq.evict(index - win + 1);
+        maxq.push(x, index);
+        minq.push(x, index);
+
+        // same window update as WelfordStd
+        const T preAvg = avg.value();
+        if (!ring.full()) {
+            ring.push(x);
+            avg.add((x - preAvg) / (T) ring.size());
+            m2.add((x - avg.value()) * (x - preAvg));
+        } else {
+            const T old = ring.front();
+            ring.push(x);
+            avg.add((x - old) / (T) win);
+            m2.add((x - old) * (x - avg.value() + old - preAvg));
+        }
+    }
+
+    // push n samples, writing the sliding std after each one
+    void process(const T *x, size_t n, T *out) {
+        for (size_t i = 0; i < n; ++i) {
+            push(x[i]);
+            out[i] = getStd();
+        }
+    }
+
+    int count() const { return (int) ring.size(); }
+
+    T mean() const { return avg.value(); }
+
+    // sample variance (ddof = 1), 0 for fewer than two samples
+    T variance() const {
+        const size_t n = ring.size();
+        return n <= 1 ? T(0) : std::max(m2.value(), T(0)) / (T) (n - 1);
+    }
+
+    T getStd() const { return std::sqrt(variance()); }
+
+    T min() const { return minq.empty() ? T(0) : minq.front(); }
+
+    T max() const { return maxq.empty() ? T(0) : maxq.front(); }
+
+    void clear() {
+        seen = 0;
+        ring.clear();
+        maxq.clear();
+        minq.clear();
+        avg.clear();
+        m2.clear();
+    }
+
+private:
+    int win;
+    int64_t seen = 0;
+    RingBuffer<T> ring;
+    MonotonicDeque<T, std::less<T>> maxq;
+    MonotonicDeque<T, std::greater<T>> minq;
+    Accumulator<T, Compensated> avg;
+    Accumulator<T, Compensated> m2;
+};
+
+
+#endif //FFALCONXR_SLIDINGSTATS_H
@@ -0,0 +1,89 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_STATEIO_H
+#define FFALCONXR_STATEIO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Flat binary checkpoint of a sliding-window object: a 4-byte tag, a format
+// version, then the object's fields as raw memcpy'd values in native byte
+// order. States are meant to be restored on the same architecture.
+class StateWriter {
+public:
+    StateWriter(const char tag[4], uint32_t version) {
+        buf.append(tag, 4);
+        put(version);
+    }
+
+    template<typename T>
+    void put(T value) {
+        static_assert(std::is_trivially_copyable<T>::value, "StateWriter: only trivially copyable values");
+        buf.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    void putArray(const T *values, size_t n) {
+        static_assert(std::is_trivially_copyable<T>::value, "StateWriter: only trivially copyable values");
+        buf.append(reinterpret_cast<const char *>(values), n * sizeof(T));
+    }
+
+    const std::string &str() const { return buf; }
+
+private:
+    std::string buf;
+};
+
+class StateReader {
+public:
+    StateReader(const std::string &state, const char tag[4], uint32_t version) :
+            data(state.data()), end(state.data() + state.size()) {
+        if (state.size() < 4 + sizeof(uint32_t) || std::memcmp(data, tag, 4) != 0) {
+            throw std::invalid_argument(std::string("state is not a serialized ") + std::string(tag, 4));
+        }
+        data += 4;
+        if (get<uint32_t>() != version) {
+            throw std::invalid_argument("unsupported state version");
+        }
+    }
+
+    template<typename T>
+    T get() {
+        T value;
+        getArray(&value, 1);
+        return value;
+    }
+
+    template<typename T>
+    void getArray(T *values, size_t n) {
+        static_assert(std::is_trivially_copyable<T>::value, "StateReader: only trivially copyable values");
+        if ((size_t) (end - data) < n * sizeof(T)) {
+            throw std::invalid_argument("truncated state");
+        }
+        std::memcpy(values, data, n * sizeof(T));
+        data += n * sizeof(T);
+    }
+
+    // bytes not read yet; bound element counts read from the state by this before allocating
+    size_t remaining() const { return (size_t) (end - data); }
+
+    // every byte must have been consumed
+    void finish() const {
+        if (data != end) {
+            throw std::invalid_argument("trailing bytes in state");
+        }
+    }
+
+private:
+    const char *data;
+    const char *end;
+};
+
+
+#endif //FFALCONXR_STATEIO_H
@@ -0,0 +1,104 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#include "TimeWindowMKAverage.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "FiniteCheck.h"
+
+TimeWindowMKAverage::TimeWindowMKAverage(double duration, int k, int capacityHint) :
+        k(k),
+        duration(duration),
+        lastT(std::numeric_limits<double>::lowest()),
+        window(std::max(capacityHint, 1)),
+        sorted(std::max(capacityHint, 1)) {
+    if (duration <= 0.0) {
+        throw std::invalid_argument("TimeWindowMKAverage: duration must be positive");
+    }
+    if (k < 0) {
+        throw std::invalid_argument("TimeWindowMKAverage: k must be non-negative");
+    }
+}
+
+void TimeWindowMKAverage::addElement(double t, double num) {
+    // NaN could never be erased from the sorted list again and would stay in the sum after eviction
+    if (!is_finite_bits(num)) {
+        throw std::invalid_argument("TimeWindowMKAverage: samples must be finite");
+    }
+    advance(t);
+    if (window.full()) {
+        window.grow();
+        sorted.grow();
+    }
+    window.push({t, num});
+
+    // same bookkeeping as MKAverage, with the upper boundary at n - k moving by one:
+    // the middle partition grows from [k, n - k) to [k, n + 1 - k)
+    const int n = sorted.size();
+    const int rank = sorted.insert(num);
+    if (n < 2 * k) {
+        return;
+    }
+    if (rank < k) {
+        sum += sorted.at(k);
+    } else if (rank < n + 1 - k) {
+        sum += num;
+    } else {
+        sum += sorted.at(n - k);
+    }
+}
+
+void TimeWindowMKAverage::advance(double t) {
+    if (!is_finite_bits(t)) {
+        throw std::invalid_argument("TimeWindowMKAverage: timestamps must be finite");
+    }
+    if (t < lastT) {
+        throw std::invalid_argument("TimeWindowMKAverage: timestamps must be non-decreasing");
+    }
+    lastT = t;
+    const double first = t - duration;
+    while (!window.empty() && window.front().t <= first) {
+        const double old = window.front().x;
+        window.popFront();
+
+        // the middle partition shrinks from [k, n - k) to [k, n - 1 - k)
+        const int n = sorted.size();
+        const int r = sorted.erase(old);
+        if (n - 1 <= 2 * k) {
+            // middle is empty now, restart exactly
+            sum = 0;
+        } else if (r < k) {
+            sum -= sorted.at(k - 1);
+        } else if (r < n - k) {
+            sum -= old;
+        } else {
+            sum -= sorted.at(n - k - 1);
+        }
+    }
+}
+
+double TimeWindowMKAverage::calculateMKAverage() const {
+    const int n = sorted.size();
+    if (n <= 2 * k)
+        return 0.0;
+    return sum / (double) (n - 2 * k);
+}
+
+int TimeWindowMKAverage::getCnt() const {
+    return sorted.size();
+}
+
+void TimeWindowMKAverage::process(const double *t, const double *x, size_t n, double *out) {
+    // checked up front so a rejected batch leaves the window untouched
+    for (size_t i = 0; i < n; ++i) {
+        if (!is_finite_bits(x[i])) {
+            throw std::invalid_argument("TimeWindowMKAverage: samples must be finite");
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        addElement(t[i], x[i]);
+        out[i] = calculateMKAverage();
+    }
+}
@@ -0,0 +1,49 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_TIMEWINDOWMKAVERAGE_H
+#define FFALCONXR_TIMEWINDOWMKAVERAGE_H
+
+#include <cstddef>
+#include "BlockedSortedList.h"
+#include "RingBuffer.h"
+
+// MKAverage over the samples whose timestamp lies in (t - duration, t]:
+// the n samples currently in the window are sorted, the k smallest and
+// k largest dropped, and the rest averaged. Returns 0 while n <= 2k.
+// Timestamps must be finite and non-decreasing and samples finite, otherwise
+// std::invalid_argument is thrown before the window changes. Storage grows
+// only when a burst holds more samples than any earlier window.
+class TimeWindowMKAverage {
+public:
+    TimeWindowMKAverage(double duration, int k, int capacityHint = 64);
+
+    void addElement(double t, double num);
+
+    // move the window end to t without adding a sample
+    void advance(double t);
+
+    double calculateMKAverage() const;
+    int getCnt() const;
+
+    // addElement + calculateMKAverage for n (t, x) pairs
+    void process(const double *t, const double *x, size_t n, double *out);
+
+private:
+    struct Sample {
+        double t;
+        double x;
+    };
+
+    int k;
+    double duration;
+    double lastT;
+    // sum of the elements ranked [k, n - k) while n > 2k
+    double sum = 0;
+    RingBuffer<Sample> window;
+    BlockedSortedList sorted;
+};
+
+
+#endif //FFALCONXR_TIMEWINDOWMKAVERAGE_H
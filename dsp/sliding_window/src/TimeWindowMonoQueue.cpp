@@ -0,0 +1,48 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#include "TimeWindowMonoQueue.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+TimeWindowMonoQueue::TimeWindowMonoQueue(double duration, int capacityHint) :
+        duration(duration),
+        lastT(std::numeric_limits<double>::lowest()),
+        m_deque(std::max(capacityHint, 1)) {
+    if (duration <= 0.0) {
+        throw std::invalid_argument("TimeWindowMonoQueue: duration must be positive");
+    }
+}
+
+void TimeWindowMonoQueue::push(double t, double val) {
+    advance(t);
+    if (m_deque.full()) {
+        m_deque.grow();
+    }
+    m_deque.push(val, t);
+}
+
+void TimeWindowMonoQueue::advance(double t) {
+    if (t < lastT) {
+        throw std::invalid_argument("TimeWindowMonoQueue: timestamps must be non-decreasing");
+    }
+    lastT = t;
+    m_deque.evictThrough(t - duration);
+}
+
+double TimeWindowMonoQueue::max() const {
+    return m_deque.empty() ? 0.0 : m_deque.front();
+}
+
+bool TimeWindowMonoQueue::empty() const {
+    return m_deque.empty();
+}
+
+void TimeWindowMonoQueue::process(const double *t, const double *x, size_t n, double *out) {
+    for (size_t i = 0; i < n; ++i) {
+        push(t[i], x[i]);
+        out[i] = m_deque.front();
+    }
+}
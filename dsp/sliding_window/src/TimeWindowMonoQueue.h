@@ -0,0 +1,38 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_TIMEWINDOWMONOQUEUE_H
+#define FFALCONXR_TIMEWINDOWMONOQUEUE_H
+
+#include <cstddef>
+#include <functional>
+#include "MonotonicDeque.h"
+
+// Sliding max over the samples whose timestamp lies in (t - duration, t].
+// Timestamps must be non-decreasing. The deque is keyed by timestamp and grows
+// only when a burst needs more room than any earlier one.
+class TimeWindowMonoQueue {
+public:
+    TimeWindowMonoQueue(double duration, int capacityHint = 64);
+
+    void push(double t, double val);
+
+    // move the window end to t without adding a sample
+    void advance(double t);
+
+    // max of the window, or 0 when it is empty
+    double max() const;
+    bool empty() const;
+
+    // push n (t, x) pairs, writing the max after each one
+    void process(const double *t, const double *x, size_t n, double *out);
+
+private:
+    double duration;
+    double lastT;
+    MonotonicDeque<double, std::less<double>, double> m_deque;
+};
+
+
+#endif //FFALCONXR_TIMEWINDOWMONOQUEUE_H
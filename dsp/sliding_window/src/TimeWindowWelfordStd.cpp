@@ -0,0 +1,82 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#include "TimeWindowWelfordStd.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+TimeWindowWelfordStd::TimeWindowWelfordStd(double duration, int capacityHint) :
+        duration(duration),
+        lastT(std::numeric_limits<double>::lowest()),
+        window(std::max(capacityHint, 1)) {
+    if (duration <= 0.0) {
+        throw std::invalid_argument("TimeWindowWelfordStd: duration must be positive");
+    }
+}
+
+double TimeWindowWelfordStd::push(double t, double x) {
+    evict(t);
+    if (window.full()) {
+        window.grow();
+    }
+    window.push({t, x});
+    const double n = (double) window.size();
+    const double d = x - mean;
+    mean += d / n;
+    m2 += d * (x - mean);
+    update();
+    return std;
+}
+
+void TimeWindowWelfordStd::advance(double t) {
+    evict(t);
+    update();
+}
+
+void TimeWindowWelfordStd::evict(double t) {
+    if (t < lastT) {
+        throw std::invalid_argument("TimeWindowWelfordStd: timestamps must be non-decreasing");
+    }
+    lastT = t;
+    const double first = t - duration;
+    while (!window.empty() && window.front().t <= first) {
+        const double x = window.front().x;
+        window.popFront();
+        if (window.size() <= 1) {
+            // restart exactly so rounding never carries over between bursts
+            mean = window.empty() ? 0.0 : window.front().x;
+            m2 = 0.0;
+            continue;
+        }
+        const double n = (double) window.size();
+        const double d = x - mean;
+        mean -= d / n;
+        m2 -= d * (x - mean);
+    }
+}
+
+void TimeWindowWelfordStd::update() {
+    const size_t n = window.size();
+    std = n <= 1 ? 0.0 : std::sqrt(std::max(m2, 0.0) / (double) (n - 1));
+}
+
+double TimeWindowWelfordStd::getStd() const {
+    return std;
+}
+
+double TimeWindowWelfordStd::getMean() const {
+    return mean;
+}
+
+int TimeWindowWelfordStd::getCnt() const {
+    return (int) window.size();
+}
+
+void TimeWindowWelfordStd::process(const double *t, const double *x, size_t n, double *out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = push(t[i], x[i]);
+    }
+}
@@ -0,0 +1,48 @@
+//
+// Created by wayne on 2026/10/16.
+//
+
+#ifndef FFALCONXR_TIMEWINDOWWELFORDSTD_H
+#define FFALCONXR_TIMEWINDOWWELFORDSTD_H
+
+#include <cstddef>
+#include "RingBuffer.h"
+
+// Sliding mean/std over the samples whose timestamp lies in (t - duration, t],
+// for streams with jitter and dropouts. Timestamps must be non-decreasing and use
+// the same unit as `duration`. The ring grows (by doubling) only when a burst holds
+// more samples than ever before, so steady-state pushes do not allocate.
+class TimeWindowWelfordStd {
+public:
+    TimeWindowWelfordStd(double duration, int capacityHint = 64);
+
+    // add a sample at time t, return the std of the window ending at t
+    double push(double t, double x);
+
+    // move the window end to t without adding a sample
+    void advance(double t);
+
+    double getStd() const;
+    double getMean() const;
+    int getCnt() const;
+
+    // push n (t, x) pairs, writing the std after each one
+    void process(const double *t, const double *x, size_t n, double *out);
+
+private:
+    struct Sample {
+        double t;
+        double x;
+    };
+
+    void evict(double t);
+    void update();
+
+    double duration;
+    double lastT;
+    double mean = 0.0, m2 = 0.0, std = 0.0;
+    RingBuffer<Sample> window;
+};
+
+
+#endif //FFALCONXR_TIMEWINDOWWELFORDSTD_H
@@ -3,21 +3,19 @@
 //
 
 #include "WelfordStd.h"
+#include "StateIO.h"
 #include <cmath>
 #include <algorithm>
 
 
-WelfordStd::WelfordStd(int win) : avg(0.0f), var(0.0f), std(0.0f), win(win), cnt(0) {
+WelfordStd::WelfordStd(int win) : avg(0.0f), var(0.0f), std(0.0f), win(win), cnt(0), window(win) {
 }
 
 double WelfordStd::calcSlidingStd(double newData) {
     cnt = std::min({cnt + 1, 100 * win});
-    deque.emplace_back(newData);
-    if (cnt > win + 1) {
-        // old_data, new_data_1, new_data_2, ..., new_data_N
-        deque.pop_front();
-    }
-    double oldData = deque.at(0);
+    // once the window is full the oldest sample leaves as the new one is written over it
+    double oldData = window.front();
+    window.push(newData);
     double preAvg = avg;
     if (cnt <= win) {
         avg += (newData - preAvg) / (double) cnt;
@@ -34,6 +32,12 @@ double WelfordStd::calcSlidingStd(double newData) {
     return std;
 }
 
+void WelfordStd::process(const double *x, size_t n, double *out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = calcSlidingStd(x[i]);
+    }
+}
+
 double WelfordStd::getStd() {
     return std;
 }
@@ -41,3 +45,45 @@ double WelfordStd::getStd() {
 int WelfordStd::getCnt() {
     return cnt;
 }
+
+std::string WelfordStd::serialize() const {
+    StateWriter w("WSTD", 1);
+    w.put<int32_t>(win);
+    w.put<int32_t>(cnt);
+    w.put(avg);
+    w.put(var);
+    w.put(std);
+    w.put<uint64_t>(window.size());
+    for (size_t i = 0; i < window.size(); ++i) {
+        w.put(window[i]);
+    }
+    return w.str();
+}
+
+WelfordStd WelfordStd::deserialize(const std::string &state) {
+    StateReader r(state, "WSTD", 1);
+    const int win = r.get<int32_t>();
+    const int cnt = r.get<int32_t>();
+    if (win <= 0 || cnt < 0 || (int64_t) cnt > 100 * (int64_t) win) {
+        throw std::invalid_argument("corrupt WelfordStd state");
+    }
+    // avg, var, std, the ring length and the min(cnt, win) ring values follow;
+    // checked before the ring of win values is allocated
+    const size_t n = (size_t) std::min(cnt, win);
+    if (r.remaining() != sizeof(double) * (3 + n) + sizeof(uint64_t)) {
+        throw std::invalid_argument("corrupt WelfordStd state");
+    }
+    WelfordStd res(win);
+    res.cnt = cnt;
+    res.avg = r.get<double>();
+    res.var = r.get<double>();
+    res.std = r.get<double>();
+    if (r.get<uint64_t>() != n) {
+        throw std::invalid_argument("corrupt WelfordStd state");
+    }
+    for (size_t i = 0; i < n; ++i) {
+        res.window.push(r.get<double>());
+    }
+    r.finish();
+    return res;
+}
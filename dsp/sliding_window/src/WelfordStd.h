@@ -6,22 +6,30 @@
 #define FFALCONXR_WELFORDSTD_H
 
 
-#include <deque>
+#include <cstddef>
+#include <string>
+#include "RingBuffer.h"
 
 class WelfordStd {
 public:
     WelfordStd(int win);
     double calcSlidingStd(double newData);
+    // calcSlidingStd for n samples, state carries over between calls
+    void process(const double *x, size_t n, double *out);
     double getStd();
     int getCnt();
 
+    // full state (accumulators and ring contents) as a flat binary blob, see StateIO.h
+    std::string serialize() const;
+    static WelfordStd deserialize(const std::string &state);
+
     double avg;
     double var;
 private:
     int win;
     int cnt;
     double std;
-    std::deque<double> deque;
+    RingBuffer<double> window;
 };
 
 